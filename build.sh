@@ -8,12 +8,24 @@ echo "Compilando proyecto VIT MNIST..."
 g++ -o programa main.cpp \
     src/matrix/matrix.cpp \
     src/matrix/matrix_ops.cpp \
+    src/matrix/workspace.cpp \
+    src/matrix/gemm.cpp \
+    src/matrix/gemm_tuning.cpp \
+    src/matrix/packed_weight.cpp \
+    src/matrix/quantized_weight.cpp \
+    src/matrix/attention.cpp \
+    src/matrix/kernels/dispatch.cpp \
+    src/matrix/kernels/kernels_scalar.cpp \
+    src/matrix/kernels/kernels_avx2.cpp \
+    src/matrix/kernels/kernels_avx512.cpp \
     src/matrix/activation_functions.h.cpp \
     src/utils/file_io.cpp \
+    src/utils/thread_pool.cpp \
     src/transformer/layer_norm.cpp \
     src/transformer/embedding.cpp \
     -Iinclude/ \
     -std=c++17 \
+    -pthread \
     -O2
 
 # Verificar si la compilación fue exitosa
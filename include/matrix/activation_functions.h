@@ -7,37 +7,67 @@
 
 #include "matrix.h"
 
+// Templated on the element type; instantiated for Matrix and MatrixF.
+// The _into variants write into a caller-provided view (which may alias the
+// input); call them with the element type spelled out, e.g. gelu_into<float>.
+// The _inplace variants overwrite their argument, e.g. softmax_inplace<T>(scores).
 namespace ActivationFunctions {
 
     // ReLU activation function
-    Matrix relu(const Matrix& input);
-    Matrix reluDerivative(const Matrix& input);
+    template <typename T> BasicMatrix<T> relu(const BasicMatrix<T>& input);
+    template <typename T> void relu_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out);
+    template <typename T> void relu_inplace(BasicMatrixView<T> matrix);
+    template <typename T> BasicMatrix<T> reluDerivative(const BasicMatrix<T>& input);
 
     // GELU activation function
-    Matrix gelu(const Matrix& input);
-    Matrix geluDerivative(const Matrix& input);
+    template <typename T> BasicMatrix<T> gelu(const BasicMatrix<T>& input);
+    template <typename T> void gelu_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out);
+    template <typename T> void gelu_inplace(BasicMatrixView<T> matrix);
+    template <typename T> BasicMatrix<T> geluDerivative(const BasicMatrix<T>& input);
 
     // Softmax activation function
-    Matrix softmax(const Matrix& input, int axis = 1);
+    template <typename T> BasicMatrix<T> softmax(const BasicMatrix<T>& input, int axis = 1);
+    // Row-wise softmax of scale * input; attention passes 1 / sqrt(head_dim)
+    template <typename T> void softmax_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out, T scale = T(1));
+    template <typename T> void softmax_inplace(BasicMatrixView<T> matrix, T scale = T(1));
 
     // Dropout (for inference, acts as identity)
-    Matrix dropout(const Matrix& input, double dropout_rate = 0.0, bool training = false);
+    template <typename T>
+    BasicMatrix<T> dropout(const BasicMatrix<T>& input, double dropout_rate = 0.0, bool training = false);
 
     // Layer normalization helpers
-    Matrix layerNorm(const Matrix& input, const Matrix& gamma, const Matrix& beta,
-                     double epsilon = 1e-5, int axis = 1);
+    template <typename T>
+    BasicMatrix<T> layerNorm(const BasicMatrix<T>& input, const BasicMatrix<T>& gamma,
+                             const BasicMatrix<T>& beta, double epsilon = 1e-5, int axis = 1);
+    template <typename T>
+    void layerNorm_into(BasicConstMatrixView<T> input, BasicConstMatrixView<T> gamma,
+                        BasicConstMatrixView<T> beta, double epsilon, BasicMatrixView<T> out);  // Row-wise
+    // Residual add fused with LayerNorm: sum = a + b, out = layerNorm(sum), in
+    // one sweep over the rows. sum may alias a or b; out must not alias sum.
+    template <typename T>
+    void addLayerNorm_into(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b, BasicConstMatrixView<T> gamma,
+                           BasicConstMatrixView<T> beta, double epsilon, BasicMatrixView<T> sum,
+                           BasicMatrixView<T> out);
 
     // Helper functions for layer normalization
     Matrix computeLayerNormStats(const Matrix& input, int axis = 1);
-    std::pair<Matrix, Matrix> computeMeanAndVariance(const Matrix& input, int axis = 1);
+    template <typename T>
+    std::pair<BasicMatrix<T>, BasicMatrix<T>> computeMeanAndVariance(const BasicMatrix<T>& input, int axis = 1);
 
     // Additional activation functions
-    Matrix sigmoid(const Matrix& input);
-    Matrix tanh(const Matrix& input);
-    Matrix leakyRelu(const Matrix& input, double alpha = 0.01);
+    template <typename T> BasicMatrix<T> sigmoid(const BasicMatrix<T>& input);
+    template <typename T> void sigmoid_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out);
+    template <typename T> void sigmoid_inplace(BasicMatrixView<T> matrix);
+    template <typename T> BasicMatrix<T> tanh(const BasicMatrix<T>& input);
+    template <typename T> void tanh_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out);
+    template <typename T> void tanh_inplace(BasicMatrixView<T> matrix);
+    template <typename T> BasicMatrix<T> leakyRelu(const BasicMatrix<T>& input, double alpha = 0.01);
+    template <typename T>
+    void leakyRelu_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out, double alpha = 0.01);
+    template <typename T> void leakyRelu_inplace(BasicMatrixView<T> matrix, double alpha = 0.01);
 
     // Utility functions
-    Matrix clip(const Matrix& input, double min_val, double max_val);
+    template <typename T> BasicMatrix<T> clip(const BasicMatrix<T>& input, double min_val, double max_val);
 }
 
 #endif //ACTIVATION_FUNCTIONS_H
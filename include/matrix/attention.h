@@ -0,0 +1,39 @@
+#ifndef ATTENTION_H
+#define ATTENTION_H
+
+#include "matrix_view.h"
+#include <cstddef>
+
+// Fused multi-head scaled dot-product attention:
+// out_h = softmax(scale * q_h * k_h^T) * v_h for every head h, where x_h is
+// column block h of x (head_dim wide for q and k, value_dim wide for v and out).
+//
+// The seq_q x seq_k score matrix is never stored. Each head is processed in
+// tiles of block_size() query rows that stream K and V as many rows at a
+// time. A tile's scores land in a small per-thread buffer and become
+// probabilities against the running row max (the online softmax_block
+// kernel). They are then multiplied into the tile's output rows, which are
+// rescaled whenever a row's max rises and divided by the row sums at the end
+// (the FlashAttention recurrence). Tiles run in parallel on the thread pool.
+namespace Attention {
+
+    // Share of L2 for one tile's working set, leaving the rest to the GEMM's
+    // packed operands (a quarter of a 1 MiB L2)
+    constexpr size_t kTileBudget = 256 * 1024;
+
+    // Query and key rows per tile for elements of element_size bytes: the
+    // largest multiple of 16 for which the square score tile plus the tile's
+    // Q, K, V and output rows fit kTileBudget. 192 for float and 128 for
+    // double with 32-wide heads.
+    size_t block_size(size_t element_size, size_t head_dim, size_t value_dim);
+
+    // q is seq_q x (heads * head_dim), k seq_k x (heads * head_dim), v seq_k x
+    // (heads * value_dim), out seq_q x (heads * value_dim); out must not
+    // alias q, k or v
+    void attention(size_t heads, ConstMatrixView q, ConstMatrixView k, ConstMatrixView v, MatrixView out,
+                   double scale);
+    void attention(size_t heads, ConstMatrixViewF q, ConstMatrixViewF k, ConstMatrixViewF v, MatrixViewF out,
+                   float scale);
+}
+
+#endif //ATTENTION_H
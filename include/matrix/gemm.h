@@ -0,0 +1,105 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "matrix_view.h"
+#include "packed_weight.h"
+#include "quantized_weight.h"
+#include <cstddef>
+
+// General matrix multiply used behind MatrixOps::matmul.
+//
+// The blocked path follows the usual Goto/BLIS layering: the K dimension is
+// split into KC-deep slabs, B slabs are packed into NR-wide column panels
+// (sized for L3), A blocks are packed into MR-tall row panels (sized for L2),
+// and an MR x NR register-blocked micro-kernel walks one panel pair at a time
+// (sized for L1). The micro-kernel and its MR x NR tile come from the
+// Kernels table selected for the host CPU.
+namespace Gemm {
+
+    // Cache blocking parameters (in elements, shared by both precisions;
+    // float blocks simply occupy half the cache)
+    struct BlockSizes {
+        size_t mc;  // Rows of A packed per block (multiple of every MR)
+        size_t kc;  // Depth of each packed slab
+        size_t nc;  // Columns of B packed per block (multiple of every NR)
+    };
+
+    // Defaults, used for every shape the tuning table has no entry for
+    const BlockSizes& block_sizes();
+
+    // Blocking and thread split for one product shape. threads caps the
+    // tiles run in parallel; 0 leaves it to the per-thread flop heuristic.
+    struct GemmConfig {
+        BlockSizes blocks;
+        size_t threads;
+    };
+
+    // Config for an m x n x k product with elements of element_size bytes:
+    // the autotuned entry for that shape if one is installed (see
+    // gemm_tuning.h), else block_sizes() and the heuristic split
+    GemmConfig config_for(size_t m, size_t n, size_t k, size_t element_size);
+
+    // kc and nc to pack a K x N weight with: those of a tuned product using
+    // that weight (any m), else the defaults
+    BlockSizes packing_blocks_for(size_t n, size_t k, size_t element_size);
+
+    // Activation applied by the fused linear epilogue
+    enum class Activation { None, ReLU, GELU };
+
+    // c = a * b, or c += a * b when accumulate is set
+    void gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate = false);
+    void gemm(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate = false);
+
+    // Transposed operands are read in their stored layout while packing, so
+    // no transposed copy is ever materialized: c = a * b^T and c = a^T * b
+    void gemm_nt(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate = false);
+    void gemm_nt(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate = false);
+    void gemm_tn(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate = false);
+    void gemm_tn(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate = false);
+
+    // Strided batched product: c_i = op(a_i) * op(b_i) for i in [0, batch),
+    // where x_i is the view x with its origin moved i * stride_x elements on
+    // (e.g. the per-head column blocks of Q, K and V, or matrices stacked in
+    // one buffer). Items run in parallel, so the c_i must not overlap. Each
+    // x_i must be a column block further along x's rows (ending within its
+    // row stride) or a whole number of rows on; invalid_argument otherwise.
+    void gemm_batched(size_t batch, ConstMatrixView a, size_t stride_a, bool trans_a,
+                      ConstMatrixView b, size_t stride_b, bool trans_b,
+                      MatrixView c, size_t stride_c, bool accumulate = false);
+    void gemm_batched(size_t batch, ConstMatrixViewF a, size_t stride_a, bool trans_a,
+                      ConstMatrixViewF b, size_t stride_b, bool trans_b,
+                      MatrixViewF c, size_t stride_c, bool accumulate = false);
+
+    // c = activation(a * b + bias), with the bias add and activation applied to
+    // each cache block of c as soon as its last K slab is done, instead of in
+    // separate passes. bias is a 1 x N row (or empty for none); trans_b reads
+    // b stored N x K, as in a * b^T.
+    void linear(ConstMatrixView a, ConstMatrixView b, ConstMatrixView bias, MatrixView c,
+                Activation activation = Activation::None, bool trans_b = false);
+    void linear(ConstMatrixViewF a, ConstMatrixViewF b, ConstMatrixViewF bias, MatrixViewF c,
+                Activation activation = Activation::None, bool trans_b = false);
+
+    // Same with b packed ahead of time, so only A is packed per call. c may
+    // cover only columns [b_col0, b_col0 + c.getCols()) of b, with b_col0 a
+    // multiple of the panel width (e.g. one part of a fused projection).
+    void linear(ConstMatrixView a, const PackedWeight& b, ConstMatrixView bias, MatrixView c,
+                Activation activation = Activation::None, size_t b_col0 = 0);
+    void linear(ConstMatrixViewF a, const PackedWeightF& b, ConstMatrixViewF bias, MatrixViewF c,
+                Activation activation = Activation::None, size_t b_col0 = 0);
+
+    // Int8 linear layer: a is quantized per tensor with a_scale (see
+    // ActivationRange), multiplied by the int8 weight with int32 accumulation,
+    // and each block of c is dequantized with a_scale * channel scale, then
+    // gets the bias and activation, as it comes out of the integer GEMM.
+    // b_col0 selects columns as for packed weights, in kPanelWidth steps.
+    void linear_int8(ConstMatrixView a, float a_scale, const QuantizedWeight& b, ConstMatrixView bias,
+                     MatrixView c, Activation activation = Activation::None, size_t b_col0 = 0);
+    void linear_int8(ConstMatrixViewF a, float a_scale, const QuantizedWeight& b, ConstMatrixViewF bias,
+                     MatrixViewF c, Activation activation = Activation::None, size_t b_col0 = 0);
+
+    // Straightforward loop nest, kept for validation and for tiny problems
+    void gemm_reference(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate = false);
+    void gemm_reference(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate = false);
+}
+
+#endif //GEMM_H
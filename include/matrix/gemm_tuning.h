@@ -0,0 +1,65 @@
+#ifndef GEMM_TUNING_H
+#define GEMM_TUNING_H
+
+#include "gemm.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Per-shape GEMM autotuning. The model runs a small fixed set of product
+// shapes, so instead of one global blocking, each shape can get the block
+// sizes and thread split that measured fastest on this host. Winners are
+// kept in a process-wide table that Gemm::config_for() consults without
+// locking, and can be saved to a cache file keyed by CPU model and
+// instruction set.
+//
+// The table is filled on first use from the file named by the
+// VIT_GEMM_TUNING environment variable, when set and written for this host.
+// Packed weights keep the blocking they were packed with, so tune (or load)
+// before building models to have their weights packed for the tuned shapes.
+namespace Gemm {
+
+    // An m x n x k product; packed_b for a weight prepacked at load time
+    // (linear layers), otherwise both operands are packed per call, with
+    // trans_b taking B as n x k (gemm_nt)
+    struct TuneShape {
+        size_t m;
+        size_t n;
+        size_t k;
+        bool packed_b;
+        bool trans_b = false;
+    };
+
+    // Shapes of the MNIST ViT forward pass: the Q/K/V/O projections, the two
+    // MLP layers, the classifier head and the score and value products of
+    // the attention tiles (sized by Attention::block_size() in f64 and f32)
+    const std::vector<TuneShape>& vit_shapes();
+
+    struct TuneResult {
+        TuneShape shape;
+        size_t element_size;  // sizeof(double) or sizeof(float)
+        GemmConfig config;    // Winner, now installed
+        double default_us;    // Time with the untuned config
+        double tuned_us;      // Time with the winner
+    };
+
+    // Benchmark candidate block sizes and thread counts for each shape in
+    // double and float, and install the fastest of each
+    std::vector<TuneResult> autotune(const std::vector<TuneShape>& shapes = vit_shapes());
+
+    void set_config(const TuneShape& shape, size_t element_size, const GemmConfig& config);
+    void clear_tuning();
+    size_t tuned_shape_count();
+
+    // Host identity the cache is keyed by: CPU model and active kernel ISA
+    std::string tuning_host_key();
+
+    // Write the table as text; false if the file cannot be written
+    bool save_tuning(const std::string& path);
+
+    // Replace the table with the file's entries. False (table unchanged) if
+    // the file is missing, malformed or was tuned on another host.
+    bool load_tuning(const std::string& path);
+}
+
+#endif //GEMM_TUNING_H
@@ -0,0 +1,69 @@
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+// 16-bit float formats for weight storage. bf16 is the upper half of a float
+// (same range, 8 significant bits); fp16 is IEEE half precision (11
+// significant bits, largest finite value 65504). Both are only storage:
+// kernels widen them to float before any arithmetic.
+
+inline uint32_t float_bits(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Round to nearest, ties to even; NaN stays NaN
+inline uint16_t float_to_bf16(float x) {
+    const uint32_t bits = float_bits(x);
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40);
+    }
+    return static_cast<uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+}
+
+inline float bf16_to_float(uint16_t h) {
+    return bits_float(uint32_t(h) << 16);
+}
+
+// Round to nearest, ties to even; overflow goes to infinity, tiny values to
+// subnormals or zero
+inline uint16_t float_to_fp16(float x) {
+    const uint32_t bits = float_bits(x);
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t abs = bits & 0x7fffffffu;
+    if (abs >= 0x7f800000u) {
+        return sign | (abs > 0x7f800000u ? 0x7e00 : 0x7c00);  // NaN, infinity
+    }
+    if (abs >= 0x477ff000u) {
+        return sign | 0x7c00;  // Rounds past 65504
+    }
+    if (abs < 0x38800000u) {
+        // Subnormal half: scale so the float addition does the rounding
+        return sign | static_cast<uint16_t>(float_bits(bits_float(abs) + 0.5f) - float_bits(0.5f));
+    }
+    const uint32_t rounded = abs + 0xfffu + ((abs >> 13) & 1u);
+    return sign | static_cast<uint16_t>((rounded - 0x38000000u) >> 13);
+}
+
+inline float fp16_to_float(uint16_t h) {
+    const uint32_t sign = uint32_t(h & 0x8000u) << 16;
+    const uint32_t abs = h & 0x7fffu;
+    if (abs >= 0x7c00u) {
+        // Infinity, or NaN quieted as vcvtph2ps does
+        const uint32_t mantissa = (abs & 0x3ffu) << 13;
+        return bits_float(sign | 0x7f800000u | mantissa | (mantissa ? 0x400000u : 0u));
+    }
+    // Rebias the exponent by multiplying; also handles subnormals
+    return bits_float(sign | float_bits(bits_float(abs << 13) * bits_float(0x77800000u)));
+}
+
+#endif //HALF_H
@@ -0,0 +1,140 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Low-level numeric kernels compiled once per instruction set and selected
+// at startup from CPUID, so a single binary runs at full width on every host.
+// All kernels work on raw contiguous pointers; the Matrix-level code in
+// MatrixOps and ActivationFunctions is responsible for shapes and strides.
+namespace Kernels {
+
+    enum class Isa { Scalar, AVX2, AVX512 };
+
+    // How the transcendental kernels (exp, tanh, sigmoid, and the softmax and
+    // GELU built on them) are computed. Exact calls libm per element. Fast
+    // uses vectorized range-reduced polynomials, with max error over the whole
+    // input range (against a long double reference for f64):
+    //
+    //              f32        f64
+    //   exp        1.1 ulp    1.2 ulp
+    //   tanh       1.4 ulp    1.4 ulp
+    //   sigmoid    2.8 ulp    3 ulp
+    //
+    // Both handle infinities and NaN like libm, and underflow to subnormals.
+    enum class MathMode { Exact, Fast };
+
+    // Kernels for one element type (double or float)
+    template <typename T>
+    struct KernelTable {
+        Isa isa;
+        const char* name;
+        MathMode math;
+
+        // GEMM micro-kernel: c[0..m, 0..n) (+)= a_panel * b_panel, where the
+        // packed A panel is gemm_mr rows and the packed B panel gemm_nr columns
+        // wide, both stored k-major. m <= gemm_mr and n <= gemm_nr.
+        size_t gemm_mr;
+        size_t gemm_nr;
+        void (*gemm_micro)(size_t kc, const T* a_panel, const T* b_panel,
+                           T* c, size_t ldc, size_t m, size_t n, bool accumulate);
+
+        // Element-wise: out[i] = a[i] op b[i] (out may alias a or b)
+        void (*add)(const T* a, const T* b, T* out, size_t n);
+        void (*sub)(const T* a, const T* b, T* out, size_t n);
+        void (*mul)(const T* a, const T* b, T* out, size_t n);
+
+        // Scalar broadcast: out[i] = a[i] * s, out[i] = a[i] + s
+        void (*scale)(const T* a, T s, T* out, size_t n);
+        void (*add_scalar)(const T* a, T s, T* out, size_t n);
+
+        // Reduction
+        T (*sum)(const T* a, size_t n);
+
+        // Element-wise transcendentals: out[i] = f(x[i]) (out may alias x)
+        void (*exp)(const T* x, T* out, size_t n);
+        void (*tanh)(const T* x, T* out, size_t n);
+        void (*sigmoid)(const T* x, T* out, size_t n);
+
+        // Row-wise activation kernels
+        void (*softmax_row)(const T* x, T scale, T* out, size_t n);  // softmax(scale * x)
+        // One block of a row of an online softmax, as in tiled attention:
+        // *max is raised to cover scale * x, *sum is rescaled to it and gains
+        // the block's exp(scale * x - *max), which overwrite x. Returns
+        // exp(old max - new max), the factor for anything else accumulated
+        // against the old max (0 on a row's first block).
+        T (*softmax_block)(T* x, T scale, size_t n, T* max, T* sum);
+        void (*gelu)(const T* x, T* out, size_t n);
+        void (*layer_norm_row)(const T* x, const T* gamma, const T* beta,
+                               T epsilon, T* out, size_t n);
+        // Residual add and LayerNorm in one sweep: sum = a + b (may alias a or
+        // b), out = layer_norm(sum) (distinct from sum)
+        void (*add_layer_norm_row)(const T* a, const T* b, const T* gamma, const T* beta,
+                                   T epsilon, T* sum, T* out, size_t n);
+    };
+
+    // Double and single precision tables compiled for one instruction set,
+    // in both math modes
+    struct KernelSet {
+        Isa isa;
+        const char* name;
+        KernelTable<double> f64;
+        KernelTable<float> f32;
+        KernelTable<double> f64_exact;
+        KernelTable<float> f32_exact;
+
+        // Int8 GEMM for quantized inference: c (m x n int32, row stride ldc) =
+        // a * b, with a m x k row-major int8 (row stride lda) and b packed in
+        // 16-column panels. Within a panel every group of 4 consecutive k is
+        // 16 x 4 bytes, one column's 4 values after another (the vpdpbusd
+        // layout). b_sums holds the sum over k of each column of b. k is a
+        // multiple of 4, n at most the packed width, and all values lie in
+        // [-127, 127].
+        void (*gemm_int8)(const int8_t* a, size_t lda, const int8_t* b, const int32_t* b_sums,
+                          int32_t* c, size_t ldc, size_t m, size_t n, size_t k);
+
+        // Widen 16-bit stored weights to float: bf16 and IEEE half precision
+        void (*bf16_to_float)(const uint16_t* src, float* dst, size_t n);
+        void (*fp16_to_float)(const uint16_t* src, float* dst, size_t n);
+    };
+
+    // Per-ISA sets (the AVX sets must only be used when supported)
+    const KernelSet& scalar_kernels();
+    const KernelSet& avx2_kernels();
+    const KernelSet& avx512_kernels();
+
+    // Best instruction set supported by this CPU and OS
+    Isa detect_isa();
+
+    // Kernels in use. Chosen on first use from detect_isa(), capped by the
+    // VIT_ISA environment variable (scalar, avx2 or avx512) when set.
+    const KernelSet& active_set();
+
+    // Math mode in use: Exact unless the VIT_MATH environment variable is
+    // "fast". set_math_mode switches it for every later kernel call.
+    MathMode math_mode();
+    void set_math_mode(MathMode mode);
+
+    template <typename T>
+    const KernelTable<T>& active();
+
+    template <>
+    inline const KernelTable<double>& active<double>() {
+        return math_mode() == MathMode::Fast ? active_set().f64 : active_set().f64_exact;
+    }
+
+    template <>
+    inline const KernelTable<float>& active<float>() {
+        return math_mode() == MathMode::Fast ? active_set().f32 : active_set().f32_exact;
+    }
+
+    // Force a specific table, e.g. to validate SIMD paths against scalar.
+    // Returns false (and changes nothing) if the CPU lacks the instruction set.
+    bool set_isa(Isa isa);
+
+    const char* isa_name(Isa isa);
+    const char* math_mode_name(MathMode mode);
+}
+
+#endif //KERNELS_H
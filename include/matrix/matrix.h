@@ -9,66 +9,174 @@
 #include <iostream>
 #include <stdexcept>
 #include <initializer_list>
-
-class Matrix {
+#include "aligned_allocator.h"
+#include "matrix_view.h"
+#include "matrix_expr.h"
+
+// Dense row-major matrix. Templated on the element type so the model can run
+// in single precision for inference while double stays available as the
+// reference: Matrix is BasicMatrix<double>, MatrixF is BasicMatrix<float>.
+// Arithmetic operators are lazy expressions (see matrix_expr.h).
+template <typename T>
+class BasicMatrix : public MatrixExpr<BasicMatrix<T>> {
 private:
-    std::vector<std::vector<double>> data;
     size_t rows;
     size_t cols;
+    // Row-major elements in a single 64-byte aligned buffer (row i starts at i * cols)
+    std::vector<T, AlignedAllocator<T, 64>> values;
+
+    void write(std::ostream& os) const;
 
 public:
+    using value_type = T;
+
     // Constructors
-    Matrix();
-    Matrix(size_t rows, size_t cols, double value = 0.0);
-    Matrix(const std::initializer_list<std::initializer_list<double>>& init_list);
+    BasicMatrix();
+    BasicMatrix(size_t rows, size_t cols, T value = T(0));
+    BasicMatrix(const std::initializer_list<std::initializer_list<T>>& init_list);
+    explicit BasicMatrix(BasicConstMatrixView<T> view);  // Deep copy of the viewed elements
+
+    // Evaluate an element-wise expression in a single pass
+    template <typename E>
+    BasicMatrix(const MatrixExpr<E>& expr);
+    template <typename E>
+    BasicMatrix& operator=(const MatrixExpr<E>& expr);
+
+    // In-place arithmetic: updates this matrix's storage without reallocating
+    template <typename E>
+    BasicMatrix& operator+=(const MatrixExpr<E>& expr);
+    template <typename E>
+    BasicMatrix& operator-=(const MatrixExpr<E>& expr);
+    BasicMatrix& operator*=(T scalar);
+    BasicMatrix& operator/=(T scalar);
 
     // Copy constructor and assignment
-    Matrix(const Matrix& other);
-    Matrix& operator=(const Matrix& other);
+    BasicMatrix(const BasicMatrix& other);
+    BasicMatrix& operator=(const BasicMatrix& other);
 
     // Move constructor and assignment
-    Matrix(Matrix&& other) noexcept;
-    Matrix& operator=(Matrix&& other) noexcept;
+    BasicMatrix(BasicMatrix&& other) noexcept;
+    BasicMatrix& operator=(BasicMatrix&& other) noexcept;
 
     // Destructor
-    ~Matrix() = default;
+    ~BasicMatrix() = default;
 
     // Element access
-    double& operator()(size_t row, size_t col);
-    const double& operator()(size_t row, size_t col) const;
+    T& operator()(size_t row, size_t col);
+    const T& operator()(size_t row, size_t col) const;
 
     // Dimensions
     size_t getRows() const { return rows; }
     size_t getCols() const { return cols; }
     std::pair<size_t, size_t> shape() const { return {rows, cols}; }
+    size_t size() const { return rows * cols; }
+
+    // Raw storage access for kernels
+    T* data() { return values.data(); }
+    const T* data() const { return values.data(); }
+    T* row_ptr(size_t row) { return values.data() + row * cols; }
+    const T* row_ptr(size_t row) const { return values.data() + row * cols; }
+    size_t getStride() const { return cols; }  // Leading dimension (elements between rows)
+    T eval(size_t i) const { return values[i]; }  // Flat element, for expression evaluation
+
+    // Non-owning views (valid until the matrix is resized or destroyed)
+    BasicMatrixView<T> view() { return BasicMatrixView<T>(values.data(), rows, cols); }
+    BasicConstMatrixView<T> view() const { return BasicConstMatrixView<T>(values.data(), rows, cols); }
+    BasicMatrixView<T> block(size_t row, size_t col, size_t num_rows, size_t num_cols);
+    BasicConstMatrixView<T> block(size_t row, size_t col, size_t num_rows, size_t num_cols) const;
+    BasicMatrixView<T> row(size_t row) { return block(row, 0, 1, cols); }
+    BasicConstMatrixView<T> row(size_t row) const { return block(row, 0, 1, cols); }
+    operator BasicMatrixView<T>() { return view(); }
+    operator BasicConstMatrixView<T>() const { return view(); }
+
+    // Element type conversion (e.g. double weights to a float model)
+    template <typename U>
+    BasicMatrix<U> cast() const;
 
     // Utility functions
-    void fill(double value);
-    void resize(size_t new_rows, size_t new_cols, double value = 0.0);
+    void fill(T value);
+    void resize(size_t new_rows, size_t new_cols, T value = T(0));
 
     // Display
     void print() const;
 
     // Static factory methods
-    static Matrix zeros(size_t rows, size_t cols);
-    static Matrix ones(size_t rows, size_t cols);
-    static Matrix identity(size_t size);
-    static Matrix random(size_t rows, size_t cols, double min = 0.0, double max = 1.0);
-
-    // Basic operators
-    Matrix operator+(const Matrix& other) const;
-    Matrix operator-(const Matrix& other) const;
-    Matrix operator*(double scalar) const;
-    Matrix operator/(double scalar) const;
+    static BasicMatrix zeros(size_t rows, size_t cols);
+    static BasicMatrix ones(size_t rows, size_t cols);
+    static BasicMatrix identity(size_t size);
+    static BasicMatrix random(size_t rows, size_t cols, T min = T(0), T max = T(1));
 
     // Comparison
-    bool operator==(const Matrix& other) const;
-    bool operator!=(const Matrix& other) const;
+    bool operator==(const BasicMatrix& other) const;
+    bool operator!=(const BasicMatrix& other) const;
 
-    // Friends for scalar operations
-    friend Matrix operator*(double scalar, const Matrix& matrix);
-    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix);
+    friend std::ostream& operator<<(std::ostream& os, const BasicMatrix& matrix) {
+        matrix.write(os);
+        return os;
+    }
 };
 
+template <typename T>
+template <typename E>
+BasicMatrix<T>::BasicMatrix(const MatrixExpr<E>& expr)
+    : rows(expr.self().getRows()), cols(expr.self().getCols()), values(rows * cols) {
+    Expr::evaluate(expr.self(), values.data(), values.size());
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator=(const MatrixExpr<E>& expr) {
+    const E& e = expr.self();
+    if (rows != e.getRows() || cols != e.getCols()) {
+        // Every operand has the expression's shape, so this matrix is not one of them
+        rows = e.getRows();
+        cols = e.getCols();
+        values.assign(rows * cols, T(0));
+    }
+    Expr::evaluate(e, values.data(), values.size());
+    return *this;
+}
+
+// The compound forms reuse the expression nodes: a += b is a = a + b with the
+// result written back over a, so the shape check and SIMD dispatch are shared.
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator+=(const MatrixExpr<E>& expr) {
+    return *this = *this + expr;
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator-=(const MatrixExpr<E>& expr) {
+    return *this = *this - expr;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(T scalar) {
+    return *this = *this * scalar;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator/=(T scalar) {
+    return *this = *this / scalar;
+}
+
+template <typename T>
+template <typename U>
+BasicMatrix<U> BasicMatrix<T>::cast() const {
+    BasicMatrix<U> result(rows, cols);
+    U* out = result.data();
+    for (size_t i = 0, n = values.size(); i < n; ++i) {
+        out[i] = static_cast<U>(values[i]);
+    }
+    return result;
+}
+
+using Matrix = BasicMatrix<double>;
+using MatrixF = BasicMatrix<float>;
+
+extern template class BasicMatrix<double>;
+extern template class BasicMatrix<float>;
+
 
 #endif //MATRIX_H
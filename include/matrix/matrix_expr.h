@@ -0,0 +1,137 @@
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include "kernels.h"
+#include <cstddef>
+#include <stdexcept>
+
+// Expression templates for element-wise Matrix arithmetic.
+//
+// a + b, a - b, a * s, s * a and a / s build lightweight nodes instead of
+// matrices; assigning or constructing a Matrix from a node evaluates the
+// whole chain in one pass, e.g. (x * scale + y) - bias reads each operand
+// once and writes the result once with no temporaries. A lone a + b, a - b
+// or a * s is handed to the SIMD kernels instead.
+//
+// Matrix operands are captured by reference, so a node must be consumed
+// within the full expression that created it (do not store one in auto).
+
+template <typename T> class BasicMatrix;
+
+// Base of everything that can appear in an element-wise expression
+template <typename E>
+class MatrixExpr {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+namespace Expr {
+
+    struct Add { template <typename T> static T apply(T a, T b) { return a + b; } };
+    struct Sub { template <typename T> static T apply(T a, T b) { return a - b; } };
+
+    // Matrices are held by reference, nested nodes by value
+    template <typename E> struct Operand { using type = const E; };
+    template <typename T> struct Operand<BasicMatrix<T>> { using type = const BasicMatrix<T>&; };
+
+    // Element-wise combination of two equally shaped expressions
+    template <typename Op, typename L, typename R>
+    class Binary : public MatrixExpr<Binary<Op, L, R>> {
+    public:
+        using value_type = typename L::value_type;
+
+    private:
+        typename Operand<L>::type lhs;
+        typename Operand<R>::type rhs;
+
+    public:
+        Binary(const L& lhs, const R& rhs, const char* message) : lhs(lhs), rhs(rhs) {
+            if (lhs.getRows() != rhs.getRows() || lhs.getCols() != rhs.getCols()) {
+                throw std::invalid_argument(message);
+            }
+        }
+
+        size_t getRows() const { return lhs.getRows(); }
+        size_t getCols() const { return lhs.getCols(); }
+        const L& left() const { return lhs; }
+        const R& right() const { return rhs; }
+        value_type eval(size_t i) const { return Op::apply(lhs.eval(i), rhs.eval(i)); }
+    };
+
+    // Expression multiplied by a scalar
+    template <typename E>
+    class Scaled : public MatrixExpr<Scaled<E>> {
+    public:
+        using value_type = typename E::value_type;
+
+    private:
+        typename Operand<E>::type expr;
+        value_type factor;
+
+    public:
+        Scaled(const E& expr, value_type factor) : expr(expr), factor(factor) {}
+
+        size_t getRows() const { return expr.getRows(); }
+        size_t getCols() const { return expr.getCols(); }
+        const E& operand() const { return expr; }
+        value_type scalar() const { return factor; }
+        value_type eval(size_t i) const { return expr.eval(i) * factor; }
+    };
+
+    // Generic case: one fused loop over the flattened elements. Every node is
+    // element-wise, so out may alias any operand.
+    template <typename E, typename T>
+    void evaluate(const E& expr, T* out, size_t n) {
+#pragma GCC ivdep
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = expr.eval(i);
+        }
+    }
+
+    // Single operations on whole matrices map directly onto a SIMD kernel
+    template <typename T>
+    void evaluate(const Binary<Add, BasicMatrix<T>, BasicMatrix<T>>& expr, T* out, size_t n) {
+        Kernels::active<T>().add(expr.left().data(), expr.right().data(), out, n);
+    }
+
+    template <typename T>
+    void evaluate(const Binary<Sub, BasicMatrix<T>, BasicMatrix<T>>& expr, T* out, size_t n) {
+        Kernels::active<T>().sub(expr.left().data(), expr.right().data(), out, n);
+    }
+
+    template <typename T>
+    void evaluate(const Scaled<BasicMatrix<T>>& expr, T* out, size_t n) {
+        Kernels::active<T>().scale(expr.operand().data(), expr.scalar(), out, n);
+    }
+}
+
+template <typename L, typename R>
+Expr::Binary<Expr::Add, L, R> operator+(const MatrixExpr<L>& a, const MatrixExpr<R>& b) {
+    return {a.self(), b.self(), "Matrices must have the same dimensions for addition"};
+}
+
+template <typename L, typename R>
+Expr::Binary<Expr::Sub, L, R> operator-(const MatrixExpr<L>& a, const MatrixExpr<R>& b) {
+    return {a.self(), b.self(), "Matrices must have the same dimensions for subtraction"};
+}
+
+template <typename E>
+Expr::Scaled<E> operator*(const MatrixExpr<E>& a, typename E::value_type scalar) {
+    return {a.self(), scalar};
+}
+
+template <typename E>
+Expr::Scaled<E> operator*(typename E::value_type scalar, const MatrixExpr<E>& a) {
+    return {a.self(), scalar};
+}
+
+// Division is multiplication by the reciprocal, as before
+template <typename E>
+Expr::Scaled<E> operator/(const MatrixExpr<E>& a, typename E::value_type scalar) {
+    if (scalar == typename E::value_type(0)) {
+        throw std::invalid_argument("Division by zero");
+    }
+    return {a.self(), typename E::value_type(1) / scalar};
+}
+
+#endif //MATRIX_EXPR_H
@@ -6,35 +6,147 @@
 #define MATRIX_OPS_H
 
 #include "matrix.h"
+#include "gemm.h"
 
 namespace MatrixOps {
+    // All operands are taken as views, so a Matrix, a sub-block or a single
+    // row can be passed without copying. Every operation has a double and a
+    // float overload; both operands must have the same precision.
+    //
+    // _into variants write to a caller-owned buffer of the result's shape and
+    // _inplace variants overwrite their first argument; for element-wise and
+    // broadcasting operations the output may alias an input.
+
     // Matrix multiplication
-    Matrix matmul(const Matrix& a, const Matrix& b);
+    Matrix matmul(ConstMatrixView a, ConstMatrixView b);
+    MatrixF matmul(ConstMatrixViewF a, ConstMatrixViewF b);
+    void matmul_into(ConstMatrixView a, ConstMatrixView b, MatrixView out);  // out = a * b
+    void matmul_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out);
+    Matrix matmul_nt(ConstMatrixView a, ConstMatrixView b);  // a * b^T, b read in place (e.g. Q * K^T)
+    MatrixF matmul_nt(ConstMatrixViewF a, ConstMatrixViewF b);
+    void matmul_nt_into(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+    void matmul_nt_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out);
+    Matrix matmul_tn(ConstMatrixView a, ConstMatrixView b);  // a^T * b, a read in place
+    MatrixF matmul_tn(ConstMatrixViewF a, ConstMatrixViewF b);
+    void matmul_tn_into(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+    void matmul_tn_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out);
+
+    // Batched out_i = op(a_i) * op(b_i) for i in [0, batch), where x_i is x moved
+    // i * stride_x elements on, e.g. every attention head in one call (see Gemm::gemm_batched)
+    void matmul_batched_into(size_t batch, ConstMatrixView a, size_t stride_a, ConstMatrixView b, size_t stride_b,
+                             MatrixView out, size_t stride_out, bool trans_a = false, bool trans_b = false);
+    void matmul_batched_into(size_t batch, ConstMatrixViewF a, size_t stride_a, ConstMatrixViewF b,
+                             size_t stride_b, MatrixViewF out, size_t stride_out, bool trans_a = false,
+                             bool trans_b = false);
+
+    // Fused linear layer: activation(input * weight + bias) in one GEMM pass,
+    // bias and activation applied per cache block of the output. The _nt form takes the
+    // weight stored (out_features, in_features). bias may be empty.
+    using Gemm::Activation;
+    Matrix linear(ConstMatrixView input, ConstMatrixView weight, ConstMatrixView bias,
+                  Activation activation = Activation::None);
+    MatrixF linear(ConstMatrixViewF input, ConstMatrixViewF weight, ConstMatrixViewF bias,
+                   Activation activation = Activation::None);
+    void linear_into(ConstMatrixView input, ConstMatrixView weight, ConstMatrixView bias, MatrixView out,
+                     Activation activation = Activation::None);
+    void linear_into(ConstMatrixViewF input, ConstMatrixViewF weight, ConstMatrixViewF bias, MatrixViewF out,
+                     Activation activation = Activation::None);
+    void linear_nt_into(ConstMatrixView input, ConstMatrixView weight, ConstMatrixView bias, MatrixView out,
+                        Activation activation = Activation::None);
+    void linear_nt_into(ConstMatrixViewF input, ConstMatrixViewF weight, ConstMatrixViewF bias, MatrixViewF out,
+                        Activation activation = Activation::None);
+
+    // Products with a weight packed once at load time (see PackedWeight)
+    void matmul_into(ConstMatrixView a, const PackedWeight& b, MatrixView out);
+    void matmul_into(ConstMatrixViewF a, const PackedWeightF& b, MatrixViewF out);
+    // weight_col0 picks out a column range of the weight (see Gemm::linear)
+    void linear_into(ConstMatrixView input, const PackedWeight& weight, ConstMatrixView bias, MatrixView out,
+                     Activation activation = Activation::None, size_t weight_col0 = 0);
+    void linear_into(ConstMatrixViewF input, const PackedWeightF& weight, ConstMatrixViewF bias, MatrixViewF out,
+                     Activation activation = Activation::None, size_t weight_col0 = 0);
+
+    // Int8 linear layer with the input quantized by input_scale (see Gemm::linear_int8)
+    void linear_int8_into(ConstMatrixView input, float input_scale, const QuantizedWeight& weight,
+                          ConstMatrixView bias, MatrixView out, Activation activation = Activation::None,
+                          size_t weight_col0 = 0);
+    void linear_int8_into(ConstMatrixViewF input, float input_scale, const QuantizedWeight& weight,
+                          ConstMatrixViewF bias, MatrixViewF out, Activation activation = Activation::None,
+                          size_t weight_col0 = 0);
+
+    Matrix matmul_reference(ConstMatrixView a, ConstMatrixView b);  // Unblocked loop, for validation
+    MatrixF matmul_reference(ConstMatrixViewF a, ConstMatrixViewF b);
 
     // Element-wise operations
-    Matrix add(const Matrix& a, const Matrix& b);          // transformer block
-    Matrix subtract(const Matrix& a, const Matrix& b);     // transformer block
-    Matrix elementWiseMultiply(const Matrix& a, const Matrix& b);
-    Matrix elementWiseDivide(const Matrix& a, const Matrix& b);
+    Matrix add(ConstMatrixView a, ConstMatrixView b);          // transformer block
+    MatrixF add(ConstMatrixViewF a, ConstMatrixViewF b);
+    void add_into(ConstMatrixView a, ConstMatrixView b, MatrixView out);  // out = a + b (out may alias a or b)
+    void add_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out);
+    void add_inplace(MatrixView a, ConstMatrixView b);  // a += b
+    void add_inplace(MatrixViewF a, ConstMatrixViewF b);
+    Matrix subtract(ConstMatrixView a, ConstMatrixView b);     // transformer block
+    MatrixF subtract(ConstMatrixViewF a, ConstMatrixViewF b);
+    void subtract_into(ConstMatrixView a, ConstMatrixView b, MatrixView out);  // out = a - b
+    void subtract_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out);
+    void subtract_inplace(MatrixView a, ConstMatrixView b);  // a -= b
+    void subtract_inplace(MatrixViewF a, ConstMatrixViewF b);
+    Matrix elementWiseMultiply(ConstMatrixView a, ConstMatrixView b);
+    MatrixF elementWiseMultiply(ConstMatrixViewF a, ConstMatrixViewF b);
+    Matrix elementWiseDivide(ConstMatrixView a, ConstMatrixView b);
+    MatrixF elementWiseDivide(ConstMatrixViewF a, ConstMatrixViewF b);
 
     // Matrix operations
-    Matrix transpose(const Matrix& matrix);
+    Matrix transpose(ConstMatrixView matrix);
+    MatrixF transpose(ConstMatrixViewF matrix);
+    void transpose_into(ConstMatrixView matrix, MatrixView out);
+    void transpose_into(ConstMatrixViewF matrix, MatrixViewF out);
+    void copy(ConstMatrixView src, MatrixView dst);
+    void copy(ConstMatrixViewF src, MatrixViewF dst);
+    void scale_into(ConstMatrixView matrix, double scalar, MatrixView out);  // out = matrix * scalar
+    void scale_into(ConstMatrixViewF matrix, float scalar, MatrixViewF out);
+    void scale_inplace(MatrixView matrix, double scalar);  // matrix *= scalar
+    void scale_inplace(MatrixViewF matrix, float scalar);
 
     // Broadcasting operations
-    Matrix addBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector = true);
-    Matrix multiplyBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector = true);
+    Matrix addBroadcast(ConstMatrixView matrix, ConstMatrixView vector, bool row_vector = true);
+    MatrixF addBroadcast(ConstMatrixViewF matrix, ConstMatrixViewF vector, bool row_vector = true);
+    void addBroadcast_into(ConstMatrixView matrix, ConstMatrixView vector, MatrixView out,
+                           bool row_vector = true);
+    void addBroadcast_into(ConstMatrixViewF matrix, ConstMatrixViewF vector, MatrixViewF out,
+                           bool row_vector = true);
+    void addBroadcast_inplace(MatrixView matrix, ConstMatrixView vector, bool row_vector = true);  // Bias add
+    void addBroadcast_inplace(MatrixViewF matrix, ConstMatrixViewF vector, bool row_vector = true);
+    Matrix multiplyBroadcast(ConstMatrixView matrix, ConstMatrixView vector, bool row_vector = true);
+    MatrixF multiplyBroadcast(ConstMatrixViewF matrix, ConstMatrixViewF vector, bool row_vector = true);
+    void multiplyBroadcast_into(ConstMatrixView matrix, ConstMatrixView vector, MatrixView out,
+                                bool row_vector = true);
+    void multiplyBroadcast_into(ConstMatrixViewF matrix, ConstMatrixViewF vector, MatrixViewF out,
+                                bool row_vector = true);
+    void multiplyBroadcast_inplace(MatrixView matrix, ConstMatrixView vector, bool row_vector = true);
+    void multiplyBroadcast_inplace(MatrixViewF matrix, ConstMatrixViewF vector, bool row_vector = true);
 
     // Reduction operations
-    double sum(const Matrix& matrix);
-    double mean(const Matrix& matrix);
-    Matrix sumAxis(const Matrix& matrix, int axis); // axis 0: sum columns, axis 1: sum rows
-    Matrix meanAxis(const Matrix& matrix, int axis);
+    double sum(ConstMatrixView matrix);
+    float sum(ConstMatrixViewF matrix);
+    double mean(ConstMatrixView matrix);
+    float mean(ConstMatrixViewF matrix);
+    Matrix sumAxis(ConstMatrixView matrix, int axis); // axis 0: sum columns, axis 1: sum rows
+    MatrixF sumAxis(ConstMatrixViewF matrix, int axis);
+    Matrix meanAxis(ConstMatrixView matrix, int axis);
+    MatrixF meanAxis(ConstMatrixViewF matrix, int axis);
 
     // Utility functions
-    Matrix power(const Matrix& matrix, double exponent);
-    Matrix sqrt(const Matrix& matrix);
-    Matrix exp(const Matrix& matrix);
-    Matrix log(const Matrix& matrix);
+    Matrix power(ConstMatrixView matrix, double exponent);
+    MatrixF power(ConstMatrixViewF matrix, double exponent);
+    Matrix sqrt(ConstMatrixView matrix);
+    MatrixF sqrt(ConstMatrixViewF matrix);
+    Matrix exp(ConstMatrixView matrix);
+    MatrixF exp(ConstMatrixViewF matrix);
+    void exp_into(ConstMatrixView matrix, MatrixView out);
+    void exp_into(ConstMatrixViewF matrix, MatrixViewF out);
+    void exp_inplace(MatrixView matrix);
+    void exp_inplace(MatrixViewF matrix);
+    Matrix log(ConstMatrixView matrix);
+    MatrixF log(ConstMatrixViewF matrix);
 
     // Matrix properties
     double trace(const Matrix& matrix);
@@ -0,0 +1,94 @@
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+
+#include <cstddef>
+
+// Non-owning views over row-major storage with an arbitrary row stride.
+// A view never allocates: head splits, row extraction and sub-blocks of a
+// Matrix are just a pointer plus shape. The viewed storage must outlive it.
+
+template <typename T>
+class BasicMatrixView {
+private:
+    T* ptr;
+    size_t rows;
+    size_t cols;
+    size_t stride;  // Elements between the starts of consecutive rows
+
+public:
+    using value_type = T;
+
+    BasicMatrixView() : ptr(nullptr), rows(0), cols(0), stride(0) {}
+    BasicMatrixView(T* ptr, size_t rows, size_t cols, size_t stride)
+        : ptr(ptr), rows(rows), cols(cols), stride(stride) {}
+    BasicMatrixView(T* ptr, size_t rows, size_t cols)
+        : ptr(ptr), rows(rows), cols(cols), stride(cols) {}
+
+    // Element access (unchecked)
+    T& operator()(size_t row, size_t col) const { return ptr[row * stride + col]; }
+
+    // Dimensions
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t getStride() const { return stride; }
+    size_t size() const { return rows * cols; }
+    bool isContiguous() const { return stride == cols || rows <= 1; }
+
+    // Raw storage access
+    T* data() const { return ptr; }
+    T* row_ptr(size_t row) const { return ptr + row * stride; }
+
+    // Sub-views
+    BasicMatrixView block(size_t row, size_t col, size_t num_rows, size_t num_cols) const {
+        return BasicMatrixView(ptr + row * stride + col, num_rows, num_cols, stride);
+    }
+    BasicMatrixView row(size_t row) const { return block(row, 0, 1, cols); }
+};
+
+template <typename T>
+class BasicConstMatrixView {
+private:
+    const T* ptr;
+    size_t rows;
+    size_t cols;
+    size_t stride;  // Elements between the starts of consecutive rows
+
+public:
+    using value_type = T;
+
+    BasicConstMatrixView() : ptr(nullptr), rows(0), cols(0), stride(0) {}
+    BasicConstMatrixView(const T* ptr, size_t rows, size_t cols, size_t stride)
+        : ptr(ptr), rows(rows), cols(cols), stride(stride) {}
+    BasicConstMatrixView(const T* ptr, size_t rows, size_t cols)
+        : ptr(ptr), rows(rows), cols(cols), stride(cols) {}
+    BasicConstMatrixView(const BasicMatrixView<T>& view)
+        : ptr(view.data()), rows(view.getRows()), cols(view.getCols()), stride(view.getStride()) {}
+
+    // Element access (unchecked)
+    const T& operator()(size_t row, size_t col) const { return ptr[row * stride + col]; }
+
+    // Dimensions
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t getStride() const { return stride; }
+    size_t size() const { return rows * cols; }
+    bool isContiguous() const { return stride == cols || rows <= 1; }
+
+    // Raw storage access
+    const T* data() const { return ptr; }
+    const T* row_ptr(size_t row) const { return ptr + row * stride; }
+
+    // Sub-views
+    BasicConstMatrixView block(size_t row, size_t col, size_t num_rows, size_t num_cols) const {
+        return BasicConstMatrixView(ptr + row * stride + col, num_rows, num_cols, stride);
+    }
+    BasicConstMatrixView row(size_t row) const { return block(row, 0, 1, cols); }
+};
+
+// Double precision (reference) and single precision (fast inference) views
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicConstMatrixView<double>;
+using MatrixViewF = BasicMatrixView<float>;
+using ConstMatrixViewF = BasicConstMatrixView<float>;
+
+#endif //MATRIX_VIEW_H
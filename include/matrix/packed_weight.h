@@ -0,0 +1,82 @@
+#ifndef PACKED_WEIGHT_H
+#define PACKED_WEIGHT_H
+
+#include "aligned_allocator.h"
+#include "matrix.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Element format of a packed weight. BF16 and FP16 halve the memory (and
+// memory traffic) of float weights and quarter that of double; the GEMM
+// widens them panel by panel and accumulates in the model's precision.
+enum class WeightStorage { Native, BF16, FP16 };
+
+const char* weight_storage_name(WeightStorage storage);
+
+// Right-hand GEMM operand packed once, in the NR-wide k-major panels the
+// blocked GEMM would otherwise rebuild from the weights on every call.
+//
+// The slabs are kc x nc as tuned for the weight's shape when it was built
+// (Gemm::packing_blocks_for), and the GEMM follows them. The panel width is
+// the micro-kernel's; if that changes (e.g. a different Kernels table is
+// forced), matches() turns false and the GEMM falls back to an unpacked
+// copy. Models
+// repack after loading; with 16-bit storage they drop their plain copy and
+// unpack() becomes the way back.
+template <typename T>
+class BasicPackedWeight {
+public:
+    BasicPackedWeight() = default;
+    // Pack weight (K x N), or weight stored N x K when transposed is set
+    explicit BasicPackedWeight(BasicConstMatrixView<T> weight, bool transposed = false,
+                               WeightStorage storage = WeightStorage::Native);
+
+    size_t getRows() const { return rows; }  // K
+    size_t getCols() const { return cols; }  // N
+    bool empty() const { return rows == 0 || cols == 0; }
+    WeightStorage getStorage() const { return storage; }
+    size_t bytes() const { return panels.size() * sizeof(T) + half_panels.size() * sizeof(uint16_t); }
+
+    // True if the panels are as wide as the active micro-kernel's
+    bool matches(size_t nr) const { return this->nr == nr; }
+    size_t getPanelWidth() const { return nr; }
+    size_t getKc() const { return kc; }
+    size_t getNc() const { return nc; }
+
+    // Panel of columns [col, col + nr) for the slab starting at depth pc;
+    // col is a multiple of nr and pc a multiple of kc. Native storage only.
+    const T* panel(size_t col, size_t pc) const;
+
+    // The same panel converted to T in dst (nr x depth values); any storage
+    void widen_panel(size_t col, size_t pc, T* dst) const;
+
+    BasicMatrix<T> unpack() const;  // Logical K x N weight
+
+private:
+    std::vector<T, AlignedAllocator<T, 64>> panels;                 // Native
+    std::vector<uint16_t, AlignedAllocator<uint16_t, 64>> half_panels;  // BF16 / FP16
+    WeightStorage storage = WeightStorage::Native;
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t nr = 0;
+    size_t kc = 0;
+    size_t nc = 0;
+
+    size_t offset(size_t col, size_t pc) const;
+};
+
+// A model component's logical weight: its plain copy, or the packed one
+// unpacked once the plain copy has been released for 16-bit storage
+template <typename T>
+BasicMatrix<T> plain_weight(const BasicMatrix<T>& plain, const BasicPackedWeight<T>& packed) {
+    return plain.size() != 0 || packed.empty() ? plain : packed.unpack();
+}
+
+using PackedWeight = BasicPackedWeight<double>;
+using PackedWeightF = BasicPackedWeight<float>;
+
+extern template class BasicPackedWeight<double>;
+extern template class BasicPackedWeight<float>;
+
+#endif //PACKED_WEIGHT_H
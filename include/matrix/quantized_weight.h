@@ -0,0 +1,77 @@
+#ifndef QUANTIZED_WEIGHT_H
+#define QUANTIZED_WEIGHT_H
+
+#include "aligned_allocator.h"
+#include "matrix_view.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Nearest value in [-127, 127], halfway cases away from zero. Kept free of
+// libm calls so quantization loops vectorize.
+inline int8_t quantize_int8(float x) {
+    x = std::min(127.0f, std::max(-127.0f, x));
+    return static_cast<int8_t>(x + (x < 0.0f ? -0.5f : 0.5f));
+}
+
+// Linear-layer weight quantized to int8 for post-training quantized
+// inference. Each output channel (column of the K x N weight) gets its own
+// symmetric scale, w ~= q * scale with q in [-127, 127]. Values are stored in
+// the panel layout Kernels::KernelSet::gemm_int8 expects: 16 columns wide,
+// K padded with zeros to a multiple of 4, each group of 4 k one column after
+// another.
+class QuantizedWeight {
+public:
+    static constexpr size_t kPanelWidth = 16;
+    static constexpr size_t kGroupDepth = 4;
+
+    QuantizedWeight() = default;
+    // Quantize weight (K x N), or weight stored N x K when transposed is set
+    explicit QuantizedWeight(ConstMatrixView weight, bool transposed = false);
+    explicit QuantizedWeight(ConstMatrixViewF weight, bool transposed = false);
+
+    size_t getRows() const { return rows; }  // K
+    size_t getCols() const { return cols; }  // N
+    size_t getDepth() const { return depth; }  // K rounded up to kGroupDepth
+    bool empty() const { return rows == 0 || cols == 0; }
+    size_t bytes() const {
+        return values.size() * sizeof(int8_t) + sums.size() * sizeof(int32_t) + scales.size() * sizeof(float);
+    }
+
+    // Panel holding columns [col, col + kPanelWidth); col is a multiple of kPanelWidth
+    const int8_t* panel(size_t col) const { return values.data() + col * depth; }
+    const int32_t* getColumnSums() const { return sums.data(); }  // Sum of each quantized column
+    const float* getScales() const { return scales.data(); }
+
+private:
+    std::vector<int8_t, AlignedAllocator<int8_t, 64>> values;  // Panels
+    std::vector<int32_t> sums;                                 // One per output channel
+    std::vector<float> scales;                                 // One per output channel
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t depth = 0;
+
+    template <typename T>
+    void quantize(BasicConstMatrixView<T> weight, bool transposed);
+};
+
+// Per-tensor symmetric int8 scale for a layer input, taken from the largest
+// |x| observed while calibrating on representative data
+class ActivationRange {
+public:
+    void observe(ConstMatrixView x);
+    void observe(ConstMatrixViewF x);
+
+    bool empty() const { return max_abs == 0.0f; }
+    float getScale() const { return max_abs / 127.0f; }
+    void reset() { max_abs = 0.0f; }
+
+private:
+    float max_abs = 0.0f;
+
+    template <typename T>
+    void observe_impl(BasicConstMatrixView<T> x);
+};
+
+#endif //QUANTIZED_WEIGHT_H
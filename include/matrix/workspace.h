@@ -0,0 +1,90 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "aligned_allocator.h"
+#include "matrix_view.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Bump allocator for the intermediate activations of a forward pass.
+//
+// Allocations are 64-byte aligned views carved out of large chunks; nothing
+// is freed individually. A Scope (or mark/release) rewinds to an earlier
+// point so per-layer or per-head temporaries are reused, and reset() frees
+// everything in O(1). When the first pass overflows the initial chunk, more
+// chunks are added and reset() merges them into one buffer sized to the
+// peak, so later passes of the same shape do not touch the system allocator.
+//
+// Views stay valid until the allocation is released or the workspace reset.
+// A workspace is not thread-safe; use one per thread.
+class Workspace {
+public:
+    // Position to rewind to (see release())
+    struct Mark {
+        size_t chunk;
+        size_t offset;
+        size_t used;
+    };
+
+    // Releases everything allocated during its lifetime
+    class Scope {
+    public:
+        explicit Scope(Workspace& workspace) : workspace(workspace), mark(workspace.mark()) {}
+        ~Scope() { workspace.release(mark); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Workspace& workspace;
+        Mark mark;
+    };
+
+    explicit Workspace(size_t initial_bytes = 0);
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+    Workspace(Workspace&&) noexcept = default;
+    Workspace& operator=(Workspace&&) noexcept = default;
+
+    // Uninitialized rows x cols matrix
+    template <typename T>
+    BasicMatrixView<T> alloc(size_t rows, size_t cols) {
+        return BasicMatrixView<T>(static_cast<T*>(allocate_bytes(rows * cols * sizeof(T))), rows, cols);
+    }
+
+    // Zero-filled rows x cols matrix
+    template <typename T>
+    BasicMatrixView<T> zeros(size_t rows, size_t cols) {
+        BasicMatrixView<T> view = alloc<T>(rows, cols);
+        std::fill(view.data(), view.data() + view.size(), T(0));
+        return view;
+    }
+
+    Mark mark() const { return {current, offset, used}; }
+    void release(const Mark& mark);
+    void reset();
+
+    // Statistics
+    size_t capacity() const;                                  // Bytes owned
+    size_t bytes_used() const { return used; }                // Bytes currently handed out or skipped over
+    size_t peak_bytes() const { return peak; }                // High-water mark since construction
+    size_t system_allocations() const { return allocations; } // Chunks requested from the system
+
+private:
+    using Chunk = std::vector<unsigned char, AlignedAllocator<unsigned char, 64>>;
+
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kMinChunkBytes = 64 * 1024;
+
+    std::vector<Chunk> chunks;
+    size_t current = 0;     // Chunk being bumped
+    size_t offset = 0;      // Next free byte in chunks[current]
+    size_t used = 0;        // Bytes handed out across all chunks
+    size_t peak = 0;
+    size_t allocations = 0;
+
+    void* allocate_bytes(size_t bytes);
+    void add_chunk(size_t bytes);
+};
+
+#endif //WORKSPACE_H
@@ -6,48 +6,99 @@
 #define EMBEDDING_H
 
 #include "../matrix/matrix.h"
+#include "../matrix/packed_weight.h"
+#include "../matrix/quantized_weight.h"
+#include "../matrix/workspace.h"
 #include "../utils/file_io.h"
 #include <string>
 
-class PatchEmbedding {
+template <typename T>
+class BasicPatchEmbedding {
 private:
-    Matrix proj_weight;         // Projection weight matrix (features, num_patches)
-    Matrix proj_bias;           // Projection bias vector (features,)
-    Matrix pos_embed;           // Positional embeddings (seq_len, features)
-    Matrix cls_token;           // Class token (1, features)
+    BasicMatrix<T> proj_weight;  // Projection weight matrix (features, num_patches)
+    BasicMatrix<T> proj_bias;    // Projection bias vector (features,)
+    BasicMatrix<T> pos_embed;    // Positional embeddings (seq_len, features)
+    BasicMatrix<T> cls_token;    // Class token (1, features)
+
+    // proj_weight transposed and packed for the GEMM; the only copy with
+    // 16-bit storage (proj_weight is released)
+    BasicPackedWeight<T> proj_weight_packed;
+    WeightStorage weight_storage = WeightStorage::Native;
+
+    // Int8 copy of proj_weight and the calibrated patch range, used once quantized
+    QuantizedWeight proj_weight_int8;
+    ActivationRange patch_range;
+    bool calibrating = false;
+    bool quantized = false;
     
     int num_patches;            // Number of patches (e.g., 49 for 7x7 patches)
     int features;               // Feature dimension (e.g., 256)
     int seq_len;                // Sequence length (num_patches + 1 for class token)
 
+    template <typename> friend class BasicPatchEmbedding;
+
+    void pack_weights();
+    BasicMatrix<T> projection_weight() const;  // proj_weight, unpacked if released
+
 public:
     // Constructor
-    PatchEmbedding(int num_patches, int features = 256);
+    BasicPatchEmbedding(int num_patches, int features = 256);
     
     // Default constructor
-    PatchEmbedding();
+    BasicPatchEmbedding();
+
+    // Copy of an embedding in the other precision
+    template <typename U>
+    explicit BasicPatchEmbedding(const BasicPatchEmbedding<U>& other)
+        : proj_weight(other.projection_weight().template cast<T>()),
+          proj_bias(other.proj_bias.template cast<T>()),
+          pos_embed(other.pos_embed.template cast<T>()),
+          cls_token(other.cls_token.template cast<T>()),
+          weight_storage(other.weight_storage),
+          num_patches(other.num_patches), features(other.features), seq_len(other.seq_len) {
+        pack_weights();
+    }
     
     // Forward pass: convert image patches to embeddings
-    Matrix forward(const Matrix& image_patches);
+    BasicMatrix<T> forward(const BasicMatrix<T>& image_patches);
+    // Same, with the result and all temporaries taken from the workspace
+    BasicMatrixView<T> forward(BasicConstMatrixView<T> image_patches, Workspace& workspace);
     
     // Load weights from CSV files
     void load_weights(const std::string& base_path);
     
     // Utility functions
-    Matrix add_class_token(const Matrix& embedded_patches);
-    Matrix add_positional_embeddings(const Matrix& embedded_with_cls);
+    BasicMatrix<T> add_class_token(const BasicMatrix<T>& embedded_patches);
+    BasicMatrix<T> add_positional_embeddings(const BasicMatrix<T>& embedded_with_cls);
     
     // Getters
-    const Matrix& get_proj_weight() const { return proj_weight; }
-    const Matrix& get_proj_bias() const { return proj_bias; }
-    const Matrix& get_pos_embed() const { return pos_embed; }
-    const Matrix& get_cls_token() const { return cls_token; }
+    BasicMatrix<T> get_proj_weight() const { return projection_weight(); }
+    const BasicMatrix<T>& get_proj_bias() const { return proj_bias; }
+    const BasicMatrix<T>& get_pos_embed() const { return pos_embed; }
+    const BasicMatrix<T>& get_cls_token() const { return cls_token; }
     int get_num_patches() const { return num_patches; }
     int get_features() const { return features; }
     int get_seq_len() const { return seq_len; }
     
     // Initialize with specific dimensions
     void initialize(int num_patches, int features);
+
+    // Storage of the projection weight; repacks it, and later loads keep it
+    void set_weight_storage(WeightStorage storage);
+    WeightStorage getWeightStorage() const { return weight_storage; }
+
+    // Int8 post-training quantization: while calibrating, forward() records the
+    // range of the patches; quantize() then runs the projection in int8
+    void set_calibrating(bool on) { calibrating = on; }
+    void quantize();
+    bool isQuantized() const { return quantized; }
+    size_t getWeightBytes() const;  // Projection weight read by forward()
 };
 
+using PatchEmbedding = BasicPatchEmbedding<double>;
+using PatchEmbeddingF = BasicPatchEmbedding<float>;
+
+extern template class BasicPatchEmbedding<double>;
+extern template class BasicPatchEmbedding<float>;
+
 #endif //EMBEDDING_H
\ No newline at end of file
@@ -9,29 +9,43 @@
 #include "../utils/file_io.h"
 #include <string>
 
-class LayerNorm {
+template <typename T>
+class BasicLayerNorm {
 private:
-    Matrix gamma;           // Scale parameters (weight)
-    Matrix beta;            // Shift parameters (bias)
+    BasicMatrix<T> gamma;   // Scale parameters (weight)
+    BasicMatrix<T> beta;    // Shift parameters (bias)
     double epsilon;         // Small constant for numerical stability
     int features;           // Number of features
 
+    template <typename> friend class BasicLayerNorm;
+
 public:
     // Constructor
-    LayerNorm(int features, double eps = 1e-5);
+    BasicLayerNorm(int features, double eps = 1e-5);
     
     // Default constructor for dynamic initialization
-    LayerNorm();
+    BasicLayerNorm();
+
+    // Copy of a layer in the other precision
+    template <typename U>
+    explicit BasicLayerNorm(const BasicLayerNorm<U>& other)
+        : gamma(other.gamma.template cast<T>()), beta(other.beta.template cast<T>()),
+          epsilon(other.epsilon), features(other.features) {}
     
     // Forward pass
-    Matrix forward(const Matrix& input);
+    BasicMatrix<T> forward(const BasicMatrix<T>& input);
+    void forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out) const;  // out may alias input
+    // sum = input + residual and out = LayerNorm(sum) in one sweep; sum may
+    // alias input or residual
+    void forward_add(BasicConstMatrixView<T> input, BasicConstMatrixView<T> residual,
+                     BasicMatrixView<T> sum, BasicMatrixView<T> out) const;
     
     // Load weights from CSV files
     void load_weights(const std::string& base_path, int layer_idx, const std::string& norm_type);
     
     // Getters
-    const Matrix& get_gamma() const { return gamma; }
-    const Matrix& get_beta() const { return beta; }
+    const BasicMatrix<T>& get_gamma() const { return gamma; }
+    const BasicMatrix<T>& get_beta() const { return beta; }
     double get_epsilon() const { return epsilon; }
     int get_features() const { return features; }
     
@@ -39,4 +53,10 @@ public:
     void initialize(int features, double eps = 1e-5);
 };
 
+using LayerNorm = BasicLayerNorm<double>;
+using LayerNormF = BasicLayerNorm<float>;
+
+extern template class BasicLayerNorm<double>;
+extern template class BasicLayerNorm<float>;
+
 #endif //LAYER_NORM_H
\ No newline at end of file
@@ -2,20 +2,68 @@
 #define MLP_H
 
 #include "../matrix/matrix.h"
+#include "../matrix/packed_weight.h"
+#include "../matrix/quantized_weight.h"
+#include "../matrix/workspace.h"
 
-class MLP {
+template <typename T>
+class BasicMLP {
 private:
     size_t input_dim;
     size_t hidden_dim;
     
-    Matrix W1, b1;  // First linear layer
-    Matrix W2, b2;  // Second linear layer
+    BasicMatrix<T> W1, b1;  // First linear layer
+    BasicMatrix<T> W2, b2;  // Second linear layer
+
+    // GEMM-ready copies of W1 and W2, rebuilt whenever the weights change.
+    // With 16-bit storage they are the only copies (W1 and W2 are released).
+    BasicPackedWeight<T> W1_packed, W2_packed;
+    WeightStorage weight_storage = WeightStorage::Native;
+
+    // Int8 copies and calibrated input ranges, used once quantized
+    QuantizedWeight W1_int8, W2_int8;
+    ActivationRange input_range, hidden_range;
+    bool calibrating = false;
+    bool quantized = false;
+
+    template <typename> friend class BasicMLP;
+
+    void pack_weights();
     
 public:
-    MLP(size_t input_dim, size_t hidden_dim);
+    BasicMLP(size_t input_dim, size_t hidden_dim);
+
+    // Copy of an MLP in the other precision
+    template <typename U>
+    explicit BasicMLP(const BasicMLP<U>& other)
+        : input_dim(other.input_dim), hidden_dim(other.hidden_dim),
+          W1(plain_weight(other.W1, other.W1_packed).template cast<T>()), b1(other.b1.template cast<T>()),
+          W2(plain_weight(other.W2, other.W2_packed).template cast<T>()), b2(other.b2.template cast<T>()),
+          weight_storage(other.weight_storage) {
+        pack_weights();
+    }
     
-    Matrix forward(const Matrix& input);
+    BasicMatrix<T> forward(const BasicMatrix<T>& input);
+    // Writes into out (must not alias input); the hidden layer comes from the workspace
+    void forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out, Workspace& workspace);
     void initialize_weights();
+
+    // Storage of the linear-layer weights; repacks them, and later loads keep it
+    void set_weight_storage(WeightStorage storage);
+    WeightStorage getWeightStorage() const { return weight_storage; }
+
+    // Int8 post-training quantization: while calibrating, forward() records the
+    // input range of each linear layer; quantize() then runs them in int8
+    void set_calibrating(bool on) { calibrating = on; }
+    void quantize();
+    bool isQuantized() const { return quantized; }
+    size_t getWeightBytes() const;  // Linear-layer weights read by forward()
 };
 
+using MLP = BasicMLP<double>;
+using MLPF = BasicMLP<float>;
+
+extern template class BasicMLP<double>;
+extern template class BasicMLP<float>;
+
 #endif
\ No newline at end of file
@@ -2,22 +2,86 @@
 #define MULTI_HEAD_ATTENTION_H
 
 #include "../matrix/matrix.h"
+#include "../matrix/packed_weight.h"
+#include "../matrix/quantized_weight.h"
+#include "../matrix/workspace.h"
 
-class MultiHeadAttention {
+template <typename T>
+class BasicMultiHeadAttention {
 private:
     size_t embed_dim;
     size_t num_heads;
     size_t head_dim;
     
-    Matrix W_q, W_k, W_v, W_o;  // Weight matrices
+    // Q, K and V projections side by side as [W_q | W_k | W_v] (embed_dim x
+    // 3 * embed_dim), so one GEMM produces all three; head h of each is
+    // column block h of its third, which the attention kernel reads in place
+    BasicMatrix<T> W_qkv, W_o;
+
+    // GEMM-ready copies of the projections, rebuilt whenever the weights change.
+    // With 16-bit storage they are the only copies (W_qkv and W_o are released).
+    BasicPackedWeight<T> W_qkv_packed, W_o_packed;
+    WeightStorage weight_storage = WeightStorage::Native;
+
+    // Int8 copies and calibrated input ranges, used once quantized
+    QuantizedWeight W_qkv_int8, W_o_int8;
+    ActivationRange input_range, heads_range;
+    bool calibrating = false;
+    bool quantized = false;
+
+    template <typename> friend class BasicMultiHeadAttention;
+
+    void pack_weights();
     
 public:
-    MultiHeadAttention(size_t embed_dim, size_t num_heads);
+    BasicMultiHeadAttention(size_t embed_dim, size_t num_heads);
+
+    // Copy of an attention layer in the other precision
+    template <typename U>
+    explicit BasicMultiHeadAttention(const BasicMultiHeadAttention<U>& other)
+        : embed_dim(other.embed_dim), num_heads(other.num_heads), head_dim(other.head_dim),
+          W_qkv(plain_weight(other.W_qkv, other.W_qkv_packed).template cast<T>()),
+          W_o(plain_weight(other.W_o, other.W_o_packed).template cast<T>()),
+          weight_storage(other.weight_storage) {
+        pack_weights();
+    }
     
-    Matrix forward(const Matrix& input);
-    Matrix scaled_dot_product_attention(const Matrix& Q, const Matrix& K, const Matrix& V);
+    BasicMatrix<T> forward(const BasicMatrix<T>& input);
+    // Writes into out (must not alias input); projections and scores come from the workspace.
+    // out may have fewer rows than input: only the leading out.getRows() tokens
+    // (e.g. the class token) are then queried, against keys and values of all tokens.
+    // A 1 x seq_len cls_attention receives token 0's attention probabilities,
+    // averaged over heads (the importance used for token pruning).
+    void forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out, Workspace& workspace,
+                 BasicMatrixView<T> cls_attention = {});
+
+    BasicMatrix<T> scaled_dot_product_attention(BasicConstMatrixView<T> Q, BasicConstMatrixView<T> K,
+                                                BasicConstMatrixView<T> V);
+    void scaled_dot_product_attention(BasicConstMatrixView<T> Q, BasicConstMatrixView<T> K,
+                                      BasicConstMatrixView<T> V, BasicMatrixView<T> out);
     
     void initialize_weights();
+    // Loads separately stored embed_dim x embed_dim projections (e.g. from a
+    // checkpoint) into the fused layout and repacks them
+    void set_weights(const BasicMatrix<T>& W_q, const BasicMatrix<T>& W_k, const BasicMatrix<T>& W_v,
+                     const BasicMatrix<T>& W_o);
+
+    // Storage of the projection weights; repacks them, and later loads keep it
+    void set_weight_storage(WeightStorage storage);
+    WeightStorage getWeightStorage() const { return weight_storage; }
+
+    // Int8 post-training quantization: while calibrating, forward() records the
+    // input range of each projection; quantize() then runs them in int8
+    void set_calibrating(bool on) { calibrating = on; }
+    void quantize();
+    bool isQuantized() const { return quantized; }
+    size_t getWeightBytes() const;  // Projection weights read by forward()
 };
 
+using MultiHeadAttention = BasicMultiHeadAttention<double>;
+using MultiHeadAttentionF = BasicMultiHeadAttention<float>;
+
+extern template class BasicMultiHeadAttention<double>;
+extern template class BasicMultiHeadAttention<float>;
+
 #endif
\ No newline at end of file
@@ -6,16 +6,58 @@
 #include "mlp.h"
 #include "layer_norm.h"
 
-class TransformerBlock {
+template <typename T>
+class BasicTransformerBlock {
 private:
-    MultiHeadAttention attention;
-    MLP mlp;
-    LayerNorm norm1, norm2;
+    BasicMultiHeadAttention<T> attention;
+    BasicMLP<T> mlp;
+    BasicLayerNorm<T> norm1, norm2;
+
+    template <typename> friend class BasicTransformerBlock;
     
 public:
-    TransformerBlock(size_t embed_dim, size_t num_heads, size_t mlp_hidden_dim);
+    BasicTransformerBlock(size_t embed_dim, size_t num_heads, size_t mlp_hidden_dim);
+
+    // Copy of a block in the other precision
+    template <typename U>
+    explicit BasicTransformerBlock(const BasicTransformerBlock<U>& other)
+        : attention(other.attention), mlp(other.mlp), norm1(other.norm1), norm2(other.norm2) {}
     
-    Matrix forward(const Matrix& input);
+    BasicMatrix<T> forward(const BasicMatrix<T>& input);
+    // Writes into out, which may alias input; temporaries come from the workspace
+    void forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out, Workspace& workspace);
+    // Form for a stack of blocks: normed holds input_norm() applied to input
+    // on entry. With next_norm, the last residual add also leaves
+    // next_norm(out) in normed, in the same sweep, for the next block.
+    // out may cover only the leading rows of input (e.g. just the class token
+    // in the last block): those tokens still attend to every token, but the
+    // attention output, norms and MLP run on them alone. cls_attention is
+    // passed on to the attention layer (see BasicMultiHeadAttention::forward).
+    void forward(BasicConstMatrixView<T> input, BasicMatrixView<T> normed, BasicMatrixView<T> out,
+                 const BasicLayerNorm<T>* next_norm, Workspace& workspace, BasicMatrixView<T> cls_attention = {});
+    const BasicLayerNorm<T>& input_norm() const { return norm1; }
+
+    void set_weight_storage(WeightStorage storage) {
+        attention.set_weight_storage(storage);
+        mlp.set_weight_storage(storage);
+    }
+
+    // Int8 post-training quantization of the attention and MLP linear layers
+    void set_calibrating(bool on) {
+        attention.set_calibrating(on);
+        mlp.set_calibrating(on);
+    }
+    void quantize() {
+        attention.quantize();
+        mlp.quantize();
+    }
+    size_t getWeightBytes() const { return attention.getWeightBytes() + mlp.getWeightBytes(); }
 };
 
+using TransformerBlock = BasicTransformerBlock<double>;
+using TransformerBlockF = BasicTransformerBlock<float>;
+
+extern template class BasicTransformerBlock<double>;
+extern template class BasicTransformerBlock<float>;
+
 #endif
\ No newline at end of file
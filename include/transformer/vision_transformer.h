@@ -6,7 +6,15 @@
 #include "embedding.h"
 #include <vector>
 
-class VisionTransformer {
+// Token reduction between blocks for inference. Prune keeps the patch
+// tokens the class token attends to most (head-averaged attention of the
+// block just run). Merge averages the most similar pairs of patch tokens
+// (ToMe-style bipartite matching on cosine similarity), so that their
+// content is not lost; a merge pass removes at most half of the patch tokens.
+enum class TokenReduction { None, Prune, Merge };
+
+template <typename T>
+class BasicVisionTransformer {
 private:
     size_t image_size;
     size_t patch_size;
@@ -16,19 +24,143 @@ private:
     size_t num_layers;
     size_t num_classes;
     
-    PatchEmbedding patch_embed;
-    Matrix pos_embedding;
-    Matrix cls_token;
-    std::vector<TransformerBlock> blocks;
-    Matrix classifier_head;
+    BasicPatchEmbedding<T> patch_embed;
+    BasicMatrix<T> pos_embedding;
+    BasicMatrix<T> cls_token;
+    std::vector<BasicTransformerBlock<T>> blocks;
+    BasicMatrix<T> classifier_head;
+    BasicPackedWeight<T> classifier_head_packed;  // Rebuilt whenever classifier_head changes
+    WeightStorage weight_storage = WeightStorage::Native;
+
+    // Early exit: optional classifier heads on the class token after
+    // individual blocks (empty where a block has none), the confidence that
+    // stops the forward pass there, and how many images stopped after each
+    // block (the last entry counts those that ran every block)
+    std::vector<BasicMatrix<T>> exit_heads;
+    std::vector<BasicPackedWeight<T>> exit_heads_packed;
+    double exit_threshold = 1.0;
+    std::vector<size_t> exit_counts;
+
+    // Token reduction after each block (keep_ratios[i] of the patch tokens
+    // entering block i + 1 survive)
+    TokenReduction token_reduction = TokenReduction::None;
+    std::vector<double> keep_ratios;
+    size_t token_rows = 0;  // Sum of sequence lengths over block runs, for getMeanTokens()
+    size_t block_runs = 0;
+
+    // Int8 copy of the classifier head and the calibrated class-token range
+    QuantizedWeight classifier_head_int8;
+    ActivationRange head_range;
+    bool calibrating = false;
+    bool quantized = false;
+
+    // Intermediate activations of forward(), reset after every call
+    Workspace workspace;
+
+    template <typename> friend class BasicVisionTransformer;
+
+    void set_calibrating(bool on);
+    void pack_classifier_head();
+    bool confident(BasicConstMatrixView<T> logits) const;
+
+    // Per-image scratch of reduce_tokens(), seq_len entries each, taken from
+    // the forward pass's workspace so that calls with separate workspaces
+    // share nothing
+    struct TokenScratch {
+        size_t* order = nullptr;
+        size_t* match = nullptr;
+        double* sizes = nullptr;  // Patches merged into each token
+        double* norms = nullptr;
+        double* scores = nullptr;
+    };
+    size_t reduce_tokens(BasicMatrixView<T> x, BasicMatrixView<T> normed, BasicConstMatrixView<T> cls_attention,
+                         double keep_ratio, const BasicLayerNorm<T>& next_norm, const TokenScratch& scratch) const;
     
 public:
-    VisionTransformer(size_t image_size, size_t patch_size, size_t embed_dim, 
-                     size_t num_heads, size_t num_layers, size_t num_classes);
+    BasicVisionTransformer(size_t image_size, size_t patch_size, size_t embed_dim,
+                           size_t num_heads, size_t num_layers, size_t num_classes,
+                           WeightStorage storage = WeightStorage::Native);
+
+    // Copy of a model in the other precision, e.g. a float model with the
+    // same weights as a double reference (the workspace is not shared)
+    template <typename U>
+    explicit BasicVisionTransformer(const BasicVisionTransformer<U>& other)
+        : image_size(other.image_size), patch_size(other.patch_size), num_patches(other.num_patches),
+          embed_dim(other.embed_dim), num_heads(other.num_heads), num_layers(other.num_layers),
+          num_classes(other.num_classes), patch_embed(other.patch_embed),
+          pos_embedding(other.pos_embedding.template cast<T>()),
+          cls_token(other.cls_token.template cast<T>()),
+          blocks(other.blocks.begin(), other.blocks.end()),
+          classifier_head(plain_weight(other.classifier_head, other.classifier_head_packed).template cast<T>()),
+          weight_storage(other.weight_storage), exit_threshold(other.exit_threshold),
+          exit_counts(num_layers, 0), token_reduction(other.token_reduction), keep_ratios(other.keep_ratios) {
+        pack_classifier_head();
+        for (size_t i = 0; i < other.exit_heads_packed.size(); ++i) {
+            if (!other.exit_heads_packed[i].empty()) {
+                set_exit_head(i + 1, plain_weight(other.exit_heads[i], other.exit_heads_packed[i]).template cast<T>());
+            }
+        }
+    }
     
-    Matrix forward(const Matrix& images);
-    Matrix image_to_patches(const Matrix& image);
+    BasicMatrix<T> forward(const BasicMatrix<T>& images);
+    // Logits for each image row written into out (batch_size x num_classes).
+    // Every intermediate comes from the workspace, so once it has grown to
+    // the peak size a call does not allocate.
+    void forward(BasicConstMatrixView<T> images, BasicMatrixView<T> out, Workspace& workspace);
+
+    BasicMatrix<T> image_to_patches(BasicConstMatrixView<T> image);
+    void image_to_patches(BasicConstMatrixView<T> image, BasicMatrixView<T> patches);
     void initialize_weights();
+
+    // Storage of every linear-layer weight (patch projection, attention, MLP
+    // and classifier head): BF16 / FP16 keep only a 16-bit packed copy. Also
+    // applies to weights loaded later. Drops any int8 quantization.
+    void set_weight_storage(WeightStorage storage);
+    WeightStorage getWeightStorage() const { return weight_storage; }
+
+    // Early-exit classification: with a head (embed_dim x num_classes) after
+    // the first `layer` blocks, an image whose softmax confidence there
+    // exceeds the threshold returns those logits and skips the remaining
+    // blocks. The default threshold of 1 never exits. Exit heads stay in
+    // floating point when the model is quantized, and calibration runs every
+    // block.
+    void set_exit_head(size_t layer, const BasicMatrix<T>& weight);
+    void clear_exit_heads();
+    void set_exit_threshold(double threshold) { exit_threshold = threshold; }
+    double getExitThreshold() const { return exit_threshold; }
+    // Images that stopped after block i + 1, counted since the last reset.
+    // These stats (and getMeanTokens()) are not synchronized: each forward()
+    // call adds its batch's counts once at the end, so concurrent calls may
+    // lose counts, and they should be read while no call is running.
+    const std::vector<size_t>& getExitCounts() const { return exit_counts; }
+    double getMeanLayers() const;  // Mean number of blocks run per image
+    void reset_exit_stats() {
+        exit_counts.assign(num_layers, 0);
+        token_rows = block_runs = 0;
+    }
+
+    // Token pruning / merging between blocks: after block i (for i below
+    // num_layers - 1), round(keep_ratios[i] * tokens) of the patch tokens go
+    // on to the next block; the class token always does. Missing entries
+    // keep every token. Results change, so this is off by default.
+    void set_token_reduction(TokenReduction mode, const std::vector<double>& keep_ratios);
+    TokenReduction getTokenReduction() const { return token_reduction; }
+    // Mean sequence length the blocks ran on since the last reset_exit_stats()
+    double getMeanTokens() const;
+
+    // Int8 post-training quantization: runs forward() over the calibration
+    // images (e.g. a sample of the training set) to record the input range of
+    // every linear layer, then switches all of them to per-channel int8
+    // weights and int8 GEMMs. Can be applied once per model.
+    void quantize(BasicConstMatrixView<T> calibration_images);
+    bool isQuantized() const { return quantized; }
+    size_t getLinearWeightBytes() const;  // Linear-layer weights read by forward()
 };
 
+using VisionTransformer = BasicVisionTransformer<double>;
+using VisionTransformerF = BasicVisionTransformer<float>;
+
+extern template class BasicVisionTransformer<double>;
+extern template class BasicVisionTransformer<float>;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Process-wide fork-join pool used by the matrix kernels.
+//
+// parallel_for(n, cost, fn) splits [0, n) into contiguous chunks and calls
+// fn(begin, end) for each one on the workers and the calling thread, then
+// returns when all chunks are done. cost is a rough per-item work estimate
+// (e.g. elements per row); jobs below the serial cutoff, calls made from
+// inside a parallel region, and calls while another thread owns the pool
+// all run inline on the caller, so callers never need their own fallback.
+//
+// The global pool starts VIT_NUM_THREADS threads (default: hardware
+// concurrency), counting the caller. Nothing allocates per call.
+class ThreadPool {
+public:
+    // Minimum total work (cost * items) worth splitting, and the smallest
+    // share handed to one thread
+    static constexpr size_t kSerialCutoff = 32 * 1024;
+    static constexpr size_t kMinChunkWork = 8 * 1024;
+
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& global();
+
+    size_t getNumThreads() const { return workers.size() + 1; }
+    void set_num_threads(size_t num_threads);  // Must not be called from a parallel region
+
+    template <typename F>
+    void parallel_for(size_t n, size_t cost, F&& fn);
+
+private:
+    using Task = void (*)(void* context, size_t begin, size_t end);
+
+    struct Job {
+        Task task = nullptr;
+        void* context = nullptr;
+        size_t n = 0;
+        size_t num_chunks = 0;
+        size_t next_chunk = 0;     // Guarded by mutex
+        size_t pending_chunks = 0; // Guarded by mutex
+        std::exception_ptr failure; // First exception thrown by a chunk
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex submit_mutex;  // Held by the thread that owns the current job
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    Job job;
+    size_t generation = 0;
+    bool stopping = false;
+
+    void start(size_t num_threads);
+    void stop();
+    void worker_loop();
+    bool run_chunk();
+    void run(size_t n, size_t num_chunks, Task task, void* context);
+    size_t chunk_count(size_t n, size_t cost) const;
+    static bool& in_parallel_region();
+
+    template <typename F>
+    static void invoke(void* context, size_t begin, size_t end) {
+        (*static_cast<F*>(context))(begin, end);
+    }
+};
+
+template <typename F>
+void ThreadPool::parallel_for(size_t n, size_t cost, F&& fn) {
+    const size_t num_chunks = chunk_count(n, cost);
+    if (num_chunks <= 1 || in_parallel_region()) {
+        fn(size_t(0), n);
+        return;
+    }
+    using Fn = std::remove_reference_t<F>;
+    run(n, num_chunks, &invoke<Fn>, const_cast<void*>(static_cast<const void*>(&fn)));
+}
+
+#endif //THREAD_POOL_H
@@ -4,6 +4,8 @@
 
 #include "../../include/matrix/activation_functions.h"
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/kernels.h"
+#include "../../include/utils/thread_pool.h"
 const double M_PI = 3.14159265358979323846;
 #include <cmath>
 #include  <random>
@@ -11,105 +13,183 @@ const double M_PI = 3.14159265358979323846;
 
 namespace ActivationFunctions {
 
-Matrix relu(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = std::max(0.0, input(i, j));
-        }
+namespace {
+
+template <typename A, typename B>
+void check_same_shape(const A& input, const B& out) {
+    if (input.getRows() != out.getRows() || input.getCols() != out.getCols()) {
+        throw std::invalid_argument("Output dimensions must match the input");
     }
-    return result;
 }
 
-Matrix reluDerivative(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = input(i, j) > 0.0 ? 1.0 : 0.0;
+// Applies f element by element, flat when both views are contiguous
+template <typename T, typename F>
+void map_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out, F f) {
+    check_same_shape(input, out);
+
+    const bool flat = input.isContiguous() && out.isContiguous();
+    const size_t rows = flat ? 1 : input.getRows();
+    const size_t cols = flat ? input.size() : input.getCols();
+    for (size_t i = 0; i < rows; ++i) {
+        const T* src = input.row_ptr(i);
+        T* dst = out.row_ptr(i);
+        for (size_t j = 0; j < cols; ++j) {
+            dst[j] = f(src[j]);
         }
     }
+}
+
+// Rough per-element cost of the transcendental row kernels relative to an
+// add, used to decide when a row split is worth the threads
+constexpr size_t kTranscendentalCost = 8;
+
+// Applies an element-wise kernel over rows split across threads, flat when
+// both views are contiguous
+template <typename T>
+void rows_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out, void (*kernel)(const T*, T*, size_t)) {
+    check_same_shape(input, out);
+
+    const bool contiguous = input.isContiguous() && out.isContiguous();
+    const size_t cols = input.getCols();
+    ThreadPool::global().parallel_for(input.getRows(), cols * kTranscendentalCost, [&](size_t begin, size_t end) {
+        if (contiguous) {
+            kernel(input.row_ptr(begin), out.row_ptr(begin), (end - begin) * cols);
+            return;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            kernel(input.row_ptr(i), out.row_ptr(i), cols);
+        }
+    });
+}
+
+} // namespace
+
+template <typename T>
+void relu_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out) {
+    map_into(input, out, [](T x) { return std::max(T(0), x); });
+}
+
+template <typename T>
+BasicMatrix<T> relu(const BasicMatrix<T>& input) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    relu_into(input.view(), result.view());
     return result;
 }
 
-Matrix gelu(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    const double sqrt_2_pi = std::sqrt(2.0 / M_PI);
+template <typename T>
+void relu_inplace(BasicMatrixView<T> matrix) {
+    relu_into<T>(matrix, matrix);
+}
 
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double x = input(i, j);
-            double tanh_arg = sqrt_2_pi * (x + 0.044715 * x * x * x);
-            result(i, j) = 0.5 * x * (1.0 + std::tanh(tanh_arg));
-        }
+template <typename T>
+BasicMatrix<T> reluDerivative(const BasicMatrix<T>& input) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    const T* src = input.data();
+    T* out = result.data();
+    for (size_t i = 0, n = input.size(); i < n; ++i) {
+        out[i] = src[i] > T(0) ? T(1) : T(0);
     }
     return result;
 }
 
-Matrix geluDerivative(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    const double sqrt_2_pi = std::sqrt(2.0 / M_PI);
+template <typename T>
+BasicMatrix<T> gelu(const BasicMatrix<T>& input) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    Kernels::active<T>().gelu(input.data(), result.data(), input.size());
+    return result;
+}
+
+template <typename T>
+void gelu_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out) {
+    rows_into(input, out, Kernels::active<T>().gelu);
+}
 
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double x = input(i, j);
-            double tanh_arg = sqrt_2_pi * (x + 0.044715 * x * x * x);
-            double tanh_val = std::tanh(tanh_arg);
-            double sech2_val = 1.0 - tanh_val * tanh_val;
+template <typename T>
+void gelu_inplace(BasicMatrixView<T> matrix) {
+    gelu_into<T>(matrix, matrix);
+}
 
-            double derivative = 0.5 * (1.0 + tanh_val) +
-                               0.5 * x * sech2_val * sqrt_2_pi * (1.0 + 3.0 * 0.044715 * x * x);
-            result(i, j) = derivative;
-        }
+template <typename T>
+BasicMatrix<T> geluDerivative(const BasicMatrix<T>& input) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    const T sqrt_2_pi = T(std::sqrt(2.0 / M_PI));
+    const T coeff = T(0.044715);
+
+    // tanh of sqrt(2/pi) * (x + 0.044715 x^3), computed in place in result
+    const T* src = input.data();
+    T* out = result.data();
+    const size_t n = input.size();
+    for (size_t i = 0; i < n; ++i) {
+        const T x = src[i];
+        out[i] = sqrt_2_pi * (x + coeff * x * x * x);
+    }
+    Kernels::active<T>().tanh(out, out, n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const T x = src[i];
+        const T tanh_val = out[i];
+        const T sech2_val = T(1) - tanh_val * tanh_val;
+        out[i] = T(0.5) * (T(1) + tanh_val) +
+                 T(0.5) * x * sech2_val * sqrt_2_pi * (T(1) + T(3) * coeff * x * x);
     }
     return result;
 }
 
-Matrix softmax(const Matrix& input, int axis) {
-    Matrix result(input.getRows(), input.getCols());
+template <typename T>
+void softmax_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out, T scale) {
+    check_same_shape(input, out);
 
-    if (axis == 1) {
-        // Softmax across columns (each row sums to 1)
-        for (size_t i = 0; i < input.getRows(); ++i) {
-            // Find max for numerical stability
-            double max_val = input(i, 0);
-            for (size_t j = 1; j < input.getCols(); ++j) {
-                max_val = std::max(max_val, input(i, j));
-            }
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const size_t cols = input.getCols();
+    ThreadPool::global().parallel_for(input.getRows(), cols * kTranscendentalCost, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            kernels.softmax_row(input.row_ptr(i), scale, out.row_ptr(i), cols);
+        }
+    });
+}
 
-            // Compute exponentials and sum
-            double sum_exp = 0.0;
-            std::vector<double> exp_vals(input.getCols());
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                exp_vals[j] = std::exp(input(i, j) - max_val);
-                sum_exp += exp_vals[j];
-            }
+template <typename T>
+BasicMatrix<T> softmax(const BasicMatrix<T>& input, int axis) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
 
-            // Normalize
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                result(i, j) = exp_vals[j] / sum_exp;
-            }
-        }
+    if (axis == 1) {
+        // Softmax across columns (each row sums to 1)
+        softmax_into(input.view(), result.view());
     } else if (axis == 0) {
-        // Softmax across rows (each column sums to 1)
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            // Find max for numerical stability
-            double max_val = input(0, j);
-            for (size_t i = 1; i < input.getRows(); ++i) {
-                max_val = std::max(max_val, input(i, j));
+        // Softmax across rows (each column sums to 1), swept a row at a time
+        // with per-column max and sum so every access is contiguous
+        const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+        const size_t rows = input.getRows();
+        const size_t cols = input.getCols();
+        if (rows == 0) {
+            return result;
+        }
+        BasicMatrix<T> column_max(1, cols);
+        BasicMatrix<T> column_sum(1, cols, T(0));
+        T* max_val = column_max.data();
+        T* sum_exp = column_sum.data();
+
+        std::copy(input.row_ptr(0), input.row_ptr(0) + cols, max_val);
+        for (size_t i = 1; i < rows; ++i) {
+            const T* row = input.row_ptr(i);
+            for (size_t j = 0; j < cols; ++j) {
+                max_val[j] = std::max(max_val[j], row[j]);
             }
+        }
 
-            // Compute exponentials and sum
-            double sum_exp = 0.0;
-            std::vector<double> exp_vals(input.getRows());
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                exp_vals[i] = std::exp(input(i, j) - max_val);
-                sum_exp += exp_vals[i];
-            }
+        for (size_t i = 0; i < rows; ++i) {
+            T* out = result.row_ptr(i);
+            kernels.sub(input.row_ptr(i), max_val, out, cols);
+            kernels.exp(out, out, cols);
+            kernels.add(sum_exp, out, sum_exp, cols);
+        }
 
-            // Normalize
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                result(i, j) = exp_vals[i] / sum_exp;
-            }
+        // Normalize
+        for (size_t j = 0; j < cols; ++j) {
+            sum_exp[j] = T(1) / sum_exp[j];
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            kernels.mul(result.row_ptr(i), sum_exp, result.row_ptr(i), cols);
         }
     } else {
         throw std::invalid_argument("Axis must be 0 or 1");
@@ -118,58 +198,70 @@ Matrix softmax(const Matrix& input, int axis) {
     return result;
 }
 
-Matrix dropout(const Matrix& input, double dropout_rate, bool training) {
+template <typename T>
+void softmax_inplace(BasicMatrixView<T> matrix, T scale) {
+    softmax_into<T>(matrix, matrix, scale);
+}
+
+template <typename T>
+BasicMatrix<T> dropout(const BasicMatrix<T>& input, double dropout_rate, bool training) {
     if (!training) {
         // During inference, dropout acts as identity
         return input;
     }
 
     // During training, randomly set elements to zero
-    Matrix result = input;
+    BasicMatrix<T> result = input;
     std::random_device rd;
     std::mt19937 gen(rd());
     std::bernoulli_distribution dis(1.0 - dropout_rate);
 
-    double scale = 1.0 / (1.0 - dropout_rate);
+    const T scale = static_cast<T>(1.0 / (1.0 - dropout_rate));
 
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            if (dis(gen)) {
-                result(i, j) *= scale;
-            } else {
-                result(i, j) = 0.0;
-            }
+    T* out = result.data();
+    for (size_t i = 0, n = result.size(); i < n; ++i) {
+        if (dis(gen)) {
+            out[i] *= scale;
+        } else {
+            out[i] = T(0);
         }
     }
 
     return result;
 }
 
-std::pair<Matrix, Matrix> computeMeanAndVariance(const Matrix& input, int axis) {
-    Matrix mean = MatrixOps::meanAxis(input, axis);
+template <typename T>
+std::pair<BasicMatrix<T>, BasicMatrix<T>> computeMeanAndVariance(const BasicMatrix<T>& input, int axis) {
+    BasicMatrix<T> mean = MatrixOps::meanAxis(input, axis);
 
-    Matrix variance;
+    BasicMatrix<T> variance;
     if (axis == 1) {
         // Compute variance across columns
-        variance = Matrix(input.getRows(), 1, 0.0);
+        variance = BasicMatrix<T>(input.getRows(), 1);
         for (size_t i = 0; i < input.getRows(); ++i) {
-            double var_sum = 0.0;
+            const T* src = input.row_ptr(i);
+            const T row_mean = mean(i, 0);
+            T var_sum = T(0);
             for (size_t j = 0; j < input.getCols(); ++j) {
-                double diff = input(i, j) - mean(i, 0);
+                T diff = src[j] - row_mean;
                 var_sum += diff * diff;
             }
             variance(i, 0) = var_sum / input.getCols();
         }
     } else if (axis == 0) {
         // Compute variance across rows
-        variance = Matrix(1, input.getCols(), 0.0);
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double var_sum = 0.0;
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                double diff = input(i, j) - mean(0, j);
-                var_sum += diff * diff;
+        variance = BasicMatrix<T>(1, input.getCols());
+        const T* col_mean = mean.data();
+        T* var_sum = variance.data();
+        for (size_t i = 0; i < input.getRows(); ++i) {
+            const T* src = input.row_ptr(i);
+            for (size_t j = 0; j < input.getCols(); ++j) {
+                T diff = src[j] - col_mean[j];
+                var_sum[j] += diff * diff;
             }
-            variance(0, j) = var_sum / input.getRows();
+        }
+        for (size_t j = 0; j < input.getCols(); ++j) {
+            var_sum[j] /= input.getRows();
         }
     } else {
         throw std::invalid_argument("Axis must be 0 or 1");
@@ -178,73 +270,201 @@ std::pair<Matrix, Matrix> computeMeanAndVariance(const Matrix& input, int axis)
     return {mean, variance};
 }
 
-Matrix layerNorm(const Matrix& input, const Matrix& gamma, const Matrix& beta,
-                 double epsilon, int axis) {
-    auto [mean, variance] = computeMeanAndVariance(input, axis);
+template <typename T>
+void layerNorm_into(BasicConstMatrixView<T> input, BasicConstMatrixView<T> gamma,
+                    BasicConstMatrixView<T> beta, double epsilon, BasicMatrixView<T> out) {
+    check_same_shape(input, out);
+    if (gamma.size() != input.getCols() || beta.size() != input.getCols()) {
+        throw std::invalid_argument("LayerNorm gamma/beta size must match the normalized dimension");
+    }
 
-    Matrix result(input.getRows(), input.getCols());
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const T eps = static_cast<T>(epsilon);
+    const size_t cols = input.getCols();
+    // Two passes over each row (one-pass statistics, then normalize)
+    ThreadPool::global().parallel_for(input.getRows(), cols * 2, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            kernels.layer_norm_row(input.row_ptr(i), gamma.data(), beta.data(), eps, out.row_ptr(i), cols);
+        }
+    });
+}
 
-    if (axis == 1) {
-        // Normalize across columns
-        for (size_t i = 0; i < input.getRows(); ++i) {
-            double std_dev = std::sqrt(variance(i, 0) + epsilon);
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                double normalized = (input(i, j) - mean(i, 0)) / std_dev;
-                result(i, j) = gamma(0, j) * normalized + beta(0, j);
-            }
+template <typename T>
+void addLayerNorm_into(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b, BasicConstMatrixView<T> gamma,
+                       BasicConstMatrixView<T> beta, double epsilon, BasicMatrixView<T> sum,
+                       BasicMatrixView<T> out) {
+    check_same_shape(a, b);
+    check_same_shape(a, sum);
+    check_same_shape(a, out);
+    if (gamma.size() != a.getCols() || beta.size() != a.getCols()) {
+        throw std::invalid_argument("LayerNorm gamma/beta size must match the normalized dimension");
+    }
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const T eps = static_cast<T>(epsilon);
+    const size_t cols = a.getCols();
+    ThreadPool::global().parallel_for(a.getRows(), cols * 3, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            kernels.add_layer_norm_row(a.row_ptr(i), b.row_ptr(i), gamma.data(), beta.data(), eps,
+                                       sum.row_ptr(i), out.row_ptr(i), cols);
         }
+    });
+}
+
+template <typename T>
+BasicMatrix<T> layerNorm(const BasicMatrix<T>& input, const BasicMatrix<T>& gamma,
+                         const BasicMatrix<T>& beta, double epsilon, int axis) {
+    const size_t norm_size = axis == 1 ? input.getCols() : input.getRows();
+    if (gamma.size() != norm_size || beta.size() != norm_size) {
+        throw std::invalid_argument("LayerNorm gamma/beta size must match the normalized dimension");
+    }
+
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+
+    if (axis == 1) {
+        // Normalize across columns, one row at a time
+        layerNorm_into(input.view(), gamma.view(), beta.view(), epsilon, result.view());
     } else if (axis == 0) {
         // Normalize across rows
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double std_dev = std::sqrt(variance(0, j) + epsilon);
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                double normalized = (input(i, j) - mean(0, j)) / std_dev;
-                result(i, j) = gamma(i, 0) * normalized + beta(i, 0);
+        auto [mean, variance] = computeMeanAndVariance(input, axis);
+
+        const T* col_mean = mean.data();
+        const T* col_var = variance.data();
+        const T* g = gamma.data();
+        const T* b = beta.data();
+        for (size_t i = 0; i < input.getRows(); ++i) {
+            const T* src = input.row_ptr(i);
+            T* out = result.row_ptr(i);
+            for (size_t j = 0; j < input.getCols(); ++j) {
+                T normalized = (src[j] - col_mean[j]) / std::sqrt(col_var[j] + static_cast<T>(epsilon));
+                out[j] = g[i] * normalized + b[i];
             }
         }
+    } else {
+        throw std::invalid_argument("Axis must be 0 or 1");
     }
 
     return result;
 }
 
-Matrix sigmoid(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = 1.0 / (1.0 + std::exp(-input(i, j)));
-        }
-    }
+template <typename T>
+void sigmoid_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out) {
+    rows_into(input, out, Kernels::active<T>().sigmoid);
+}
+
+template <typename T>
+BasicMatrix<T> sigmoid(const BasicMatrix<T>& input) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    sigmoid_into(input.view(), result.view());
     return result;
 }
 
-Matrix tanh(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = std::tanh(input(i, j));
-        }
-    }
+template <typename T>
+void sigmoid_inplace(BasicMatrixView<T> matrix) {
+    sigmoid_into<T>(matrix, matrix);
+}
+
+template <typename T>
+void tanh_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out) {
+    rows_into(input, out, Kernels::active<T>().tanh);
+}
+
+template <typename T>
+BasicMatrix<T> tanh(const BasicMatrix<T>& input) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    tanh_into(input.view(), result.view());
     return result;
 }
 
-Matrix leakyRelu(const Matrix& input, double alpha) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = input(i, j) > 0.0 ? input(i, j) : alpha * input(i, j);
-        }
-    }
+template <typename T>
+void tanh_inplace(BasicMatrixView<T> matrix) {
+    tanh_into<T>(matrix, matrix);
+}
+
+template <typename T>
+void leakyRelu_into(BasicConstMatrixView<T> input, BasicMatrixView<T> out, double alpha) {
+    const T a = static_cast<T>(alpha);
+    map_into(input, out, [a](T x) { return x > T(0) ? x : a * x; });
+}
+
+template <typename T>
+BasicMatrix<T> leakyRelu(const BasicMatrix<T>& input, double alpha) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    leakyRelu_into(input.view(), result.view(), alpha);
     return result;
 }
 
-Matrix clip(const Matrix& input, double min_val, double max_val) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = std::clamp(input(i, j), min_val, max_val);
-        }
+template <typename T>
+void leakyRelu_inplace(BasicMatrixView<T> matrix, double alpha) {
+    leakyRelu_into<T>(matrix, matrix, alpha);
+}
+
+template <typename T>
+BasicMatrix<T> clip(const BasicMatrix<T>& input, double min_val, double max_val) {
+    BasicMatrix<T> result(input.getRows(), input.getCols());
+    const T* src = input.data();
+    T* out = result.data();
+    for (size_t i = 0, n = input.size(); i < n; ++i) {
+        out[i] = std::clamp(src[i], static_cast<T>(min_val), static_cast<T>(max_val));
     }
     return result;
 }
 
+// Explicit instantiations for Matrix and MatrixF
+template BasicMatrix<double> relu(const BasicMatrix<double>&);
+template void relu_into(BasicConstMatrixView<double>, BasicMatrixView<double>);
+template void relu_inplace(BasicMatrixView<double>);
+template BasicMatrix<double> reluDerivative(const BasicMatrix<double>&);
+template BasicMatrix<double> gelu(const BasicMatrix<double>&);
+template void gelu_into(BasicConstMatrixView<double>, BasicMatrixView<double>);
+template void gelu_inplace(BasicMatrixView<double>);
+template BasicMatrix<double> geluDerivative(const BasicMatrix<double>&);
+template BasicMatrix<double> softmax(const BasicMatrix<double>&, int);
+template void softmax_into(BasicConstMatrixView<double>, BasicMatrixView<double>, double);
+template void softmax_inplace(BasicMatrixView<double>, double);
+template BasicMatrix<double> dropout(const BasicMatrix<double>&, double, bool);
+template std::pair<BasicMatrix<double>, BasicMatrix<double>> computeMeanAndVariance(const BasicMatrix<double>&, int);
+template BasicMatrix<double> layerNorm(const BasicMatrix<double>&, const BasicMatrix<double>&, const BasicMatrix<double>&, double, int);
+template void layerNorm_into(BasicConstMatrixView<double>, BasicConstMatrixView<double>, BasicConstMatrixView<double>, double, BasicMatrixView<double>);
+template void addLayerNorm_into(BasicConstMatrixView<double>, BasicConstMatrixView<double>, BasicConstMatrixView<double>,
+                                BasicConstMatrixView<double>, double, BasicMatrixView<double>, BasicMatrixView<double>);
+template BasicMatrix<double> sigmoid(const BasicMatrix<double>&);
+template void sigmoid_into(BasicConstMatrixView<double>, BasicMatrixView<double>);
+template void sigmoid_inplace(BasicMatrixView<double>);
+template BasicMatrix<double> tanh(const BasicMatrix<double>&);
+template void tanh_into(BasicConstMatrixView<double>, BasicMatrixView<double>);
+template void tanh_inplace(BasicMatrixView<double>);
+template BasicMatrix<double> leakyRelu(const BasicMatrix<double>&, double);
+template void leakyRelu_into(BasicConstMatrixView<double>, BasicMatrixView<double>, double);
+template void leakyRelu_inplace(BasicMatrixView<double>, double);
+template BasicMatrix<double> clip(const BasicMatrix<double>&, double, double);
+
+template BasicMatrix<float> relu(const BasicMatrix<float>&);
+template void relu_into(BasicConstMatrixView<float>, BasicMatrixView<float>);
+template void relu_inplace(BasicMatrixView<float>);
+template BasicMatrix<float> reluDerivative(const BasicMatrix<float>&);
+template BasicMatrix<float> gelu(const BasicMatrix<float>&);
+template void gelu_into(BasicConstMatrixView<float>, BasicMatrixView<float>);
+template void gelu_inplace(BasicMatrixView<float>);
+template BasicMatrix<float> geluDerivative(const BasicMatrix<float>&);
+template BasicMatrix<float> softmax(const BasicMatrix<float>&, int);
+template void softmax_into(BasicConstMatrixView<float>, BasicMatrixView<float>, float);
+template void softmax_inplace(BasicMatrixView<float>, float);
+template BasicMatrix<float> dropout(const BasicMatrix<float>&, double, bool);
+template std::pair<BasicMatrix<float>, BasicMatrix<float>> computeMeanAndVariance(const BasicMatrix<float>&, int);
+template BasicMatrix<float> layerNorm(const BasicMatrix<float>&, const BasicMatrix<float>&, const BasicMatrix<float>&, double, int);
+template void layerNorm_into(BasicConstMatrixView<float>, BasicConstMatrixView<float>, BasicConstMatrixView<float>, double, BasicMatrixView<float>);
+template void addLayerNorm_into(BasicConstMatrixView<float>, BasicConstMatrixView<float>, BasicConstMatrixView<float>,
+                                BasicConstMatrixView<float>, double, BasicMatrixView<float>, BasicMatrixView<float>);
+template BasicMatrix<float> sigmoid(const BasicMatrix<float>&);
+template void sigmoid_into(BasicConstMatrixView<float>, BasicMatrixView<float>);
+template void sigmoid_inplace(BasicMatrixView<float>);
+template BasicMatrix<float> tanh(const BasicMatrix<float>&);
+template void tanh_into(BasicConstMatrixView<float>, BasicMatrixView<float>);
+template void tanh_inplace(BasicMatrixView<float>);
+template BasicMatrix<float> leakyRelu(const BasicMatrix<float>&, double);
+template void leakyRelu_into(BasicConstMatrixView<float>, BasicMatrixView<float>, double);
+template void leakyRelu_inplace(BasicMatrixView<float>, double);
+template BasicMatrix<float> clip(const BasicMatrix<float>&, double, double);
+
 } // namespace Act
\ No newline at end of file
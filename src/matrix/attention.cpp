@@ -0,0 +1,124 @@
+#include "../../include/matrix/attention.h"
+#include "../../include/matrix/aligned_allocator.h"
+#include "../../include/matrix/gemm.h"
+#include "../../include/matrix/kernels.h"
+#include "../../include/utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Attention {
+
+namespace {
+
+template <typename T>
+using Scratch = std::vector<T, AlignedAllocator<T, 64>>;
+
+// Score tile and row statistics of one thread, reused across calls so
+// steady state does not allocate
+template <typename T>
+struct TileScratch {
+    Scratch<T> scores;
+    Scratch<T> row_max;
+    Scratch<T> row_sum;
+};
+
+template <typename T>
+TileScratch<T>& tile_scratch() {
+    thread_local TileScratch<T> scratch;
+    return scratch;
+}
+
+// One query tile of one head: q and out are the tile's rows of the head's
+// column blocks, k and v the head's whole blocks
+template <typename T>
+void attention_tile(BasicConstMatrixView<T> q, BasicConstMatrixView<T> k, BasicConstMatrixView<T> v,
+                    BasicMatrixView<T> out, T scale, size_t block) {
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const size_t rows = q.getRows();
+    const size_t seq_k = k.getRows();
+    const size_t head_dim = q.getCols();
+    const size_t value_dim = v.getCols();
+
+    TileScratch<T>& scratch = tile_scratch<T>();
+    scratch.scores.resize(block * block);
+    scratch.row_max.assign(rows, -std::numeric_limits<T>::infinity());
+    scratch.row_sum.assign(rows, T(0));
+
+    for (size_t j0 = 0; j0 < seq_k; j0 += block) {
+        const size_t cols = std::min(block, seq_k - j0);
+        BasicMatrixView<T> scores(scratch.scores.data(), rows, cols, block);
+        Gemm::gemm_nt(q, k.block(j0, 0, cols, head_dim), scores);
+
+        // Probabilities against each row's running max; output rows already
+        // holding earlier blocks are brought to the new max
+        for (size_t i = 0; i < rows; ++i) {
+            const T factor = kernels.softmax_block(scores.row_ptr(i), scale, cols, &scratch.row_max[i],
+                                                   &scratch.row_sum[i]);
+            if (j0 > 0 && factor != T(1)) {
+                kernels.scale(out.row_ptr(i), factor, out.row_ptr(i), value_dim);
+            }
+        }
+        Gemm::gemm(scores, v.block(j0, 0, cols, value_dim), out, j0 > 0);
+    }
+
+    for (size_t i = 0; i < rows; ++i) {
+        kernels.scale(out.row_ptr(i), T(1) / scratch.row_sum[i], out.row_ptr(i), value_dim);
+    }
+}
+
+template <typename T>
+void attention_impl(size_t heads, BasicConstMatrixView<T> q, BasicConstMatrixView<T> k, BasicConstMatrixView<T> v,
+                    BasicMatrixView<T> out, T scale) {
+    if (heads == 0 || q.getCols() % heads != 0 || v.getCols() % heads != 0 || k.getCols() != q.getCols() ||
+        v.getRows() != k.getRows() || out.getRows() != q.getRows() || out.getCols() != v.getCols()) {
+        throw std::invalid_argument("Attention shapes do not match");
+    }
+    if (k.getRows() == 0) {
+        throw std::invalid_argument("Attention needs at least one key");
+    }
+
+    const size_t seq_q = q.getRows();
+    const size_t seq_k = k.getRows();
+    const size_t head_dim = q.getCols() / heads;
+    const size_t value_dim = v.getCols() / heads;
+    const size_t block = block_size(sizeof(T), head_dim, value_dim);
+    const size_t query_tiles = (seq_q + block - 1) / block;
+
+    // Tiles are independent: each writes its own rows of its own head
+    const size_t tile_cost = block * seq_k * (head_dim + value_dim);
+    ThreadPool::global().parallel_for(heads * query_tiles, tile_cost, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const size_t h = t / query_tiles;
+            const size_t i0 = t % query_tiles * block;
+            const size_t rows = std::min(block, seq_q - i0);
+            attention_tile(q.block(i0, h * head_dim, rows, head_dim), k.block(0, h * head_dim, seq_k, head_dim),
+                           v.block(0, h * value_dim, seq_k, value_dim),
+                           out.block(i0, h * value_dim, rows, value_dim), scale, block);
+        }
+    });
+}
+
+} // namespace
+
+size_t block_size(size_t element_size, size_t head_dim, size_t value_dim) {
+    // Largest b with b * b + b * per_row <= budget
+    const double budget = double(kTileBudget / element_size);
+    const double per_row = 2.0 * double(head_dim + value_dim);
+    const size_t b = size_t((std::sqrt(per_row * per_row + 4.0 * budget) - per_row) / 2.0);
+    return std::max<size_t>(16, b / 16 * 16);
+}
+
+void attention(size_t heads, ConstMatrixView q, ConstMatrixView k, ConstMatrixView v, MatrixView out,
+               double scale) {
+    attention_impl(heads, q, k, v, out, scale);
+}
+
+void attention(size_t heads, ConstMatrixViewF q, ConstMatrixViewF k, ConstMatrixViewF v, MatrixViewF out,
+               float scale) {
+    attention_impl(heads, q, k, v, out, scale);
+}
+
+} // namespace Attention
@@ -0,0 +1,546 @@
+#include "../../include/matrix/gemm.h"
+#include "../../include/matrix/aligned_allocator.h"
+#include "../../include/matrix/kernels.h"
+#include "../../include/utils/thread_pool.h"
+#include "gemm_packing.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Gemm {
+
+namespace {
+
+using detail::pack_a;
+using detail::pack_b;
+
+// Problems below this many multiply-adds are cheaper without packing
+constexpr size_t kSmallProblemFlops = 16 * 1024;
+
+// Each thread should get at least this many multiply-adds, or waking it
+// costs more than it saves
+constexpr size_t kParallelFlopsPerThread = 256 * 1024;
+
+// Rows of c produced per int8 kernel call; bounds the int32 scratch per thread
+constexpr size_t kInt8RowBlock = 16;
+
+template <typename T>
+using PackBuffer = std::vector<T, AlignedAllocator<T, 64>>;
+
+// Packing buffers are reused across calls, so steady state does not allocate
+template <typename T>
+PackBuffer<T>& a_pack_buffer() {
+    thread_local PackBuffer<T> buffer;
+    return buffer;
+}
+
+template <typename T>
+PackBuffer<T>& b_pack_buffer() {
+    thread_local PackBuffer<T> buffer;
+    return buffer;
+}
+
+// Bias and activation applied to finished rows of c. bias points at the
+// entry for c's first column (the caller offsets it for sub-tiles).
+template <typename T>
+struct Epilogue {
+    const T* bias = nullptr;
+    Activation activation = Activation::None;
+
+    bool empty() const { return bias == nullptr && activation == Activation::None; }
+
+    Epilogue shifted(size_t col) const { return {bias ? bias + col : nullptr, activation}; }
+
+    void apply(const Kernels::KernelTable<T>& kernels, T* c, size_t ldc, size_t m, size_t n) const {
+        for (size_t i = 0; i < m; ++i) {
+            T* row = c + i * ldc;
+            if (bias) {
+                kernels.add(row, bias, row, n);
+            }
+            if (activation == Activation::GELU) {
+                kernels.gelu(row, row, n);
+            } else if (activation == Activation::ReLU) {
+                for (size_t j = 0; j < n; ++j) {
+                    row[j] = std::max(T(0), row[j]);
+                }
+            }
+        }
+    }
+};
+
+// Logical shape of an operand that may be read transposed
+template <typename T>
+size_t op_rows(BasicConstMatrixView<T> m, bool trans) { return trans ? m.getCols() : m.getRows(); }
+template <typename T>
+size_t op_cols(BasicConstMatrixView<T> m, bool trans) { return trans ? m.getRows() : m.getCols(); }
+
+template <typename T>
+void check_shapes(BasicConstMatrixView<T> a, bool trans_a, BasicConstMatrixView<T> b, bool trans_b,
+                  BasicMatrixView<T> c) {
+    if (op_cols(a, trans_a) != op_rows(b, trans_b)) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (c.getRows() != op_rows(a, trans_a) || c.getCols() != op_cols(b, trans_b)) {
+        throw std::invalid_argument("Output dimensions incompatible for multiplication");
+    }
+}
+
+// Item i of a strided batch is x moved i * stride elements on, with item 0's
+// shape. The views carry no buffer length, so its layout is what can be
+// checked: each item is either a column block further along item 0's rows,
+// ending within the row stride, or a whole number of rows further on (how
+// stacked matrices are laid out).
+template <typename T>
+void check_batch_items(size_t batch, BasicConstMatrixView<T> x, size_t stride) {
+    if (batch <= 1 || x.size() == 0) {
+        return;
+    }
+    const size_t row = x.getStride();
+    const bool in_rows = stride < row && (batch - 1) * stride + x.getCols() <= row;
+    if (!in_rows && stride % row != 0) {
+        throw std::invalid_argument("Batched items must be column blocks within the rows or whole rows apart");
+    }
+}
+
+template <typename T>
+void gemm_reference_impl(BasicConstMatrixView<T> a, bool trans_a, BasicConstMatrixView<T> b, bool trans_b,
+                         BasicMatrixView<T> c, bool accumulate, const Epilogue<T>& epilogue = {}) {
+    check_shapes(a, trans_a, b, trans_b, c);
+
+    const size_t rows = c.getRows();
+    const size_t cols = c.getCols();
+    const size_t inner = op_cols(a, trans_a);
+
+    if (!accumulate) {
+        for (size_t i = 0; i < rows; ++i) {
+            std::fill(c.row_ptr(i), c.row_ptr(i) + cols, T(0));
+        }
+    }
+
+    if (trans_b && !trans_a) {
+        // a * b^T: every element is a dot product of two stored rows
+        for (size_t i = 0; i < rows; ++i) {
+            const T* a_row = a.row_ptr(i);
+            T* c_row = c.row_ptr(i);
+            for (size_t j = 0; j < cols; ++j) {
+                const T* b_row = b.row_ptr(j);
+                T dot = T(0);
+                for (size_t k = 0; k < inner; ++k) {
+                    dot += a_row[k] * b_row[k];
+                }
+                c_row[j] += dot;
+            }
+        }
+    } else {
+        // i-k-j order so that rows of b and c are streamed contiguously
+        for (size_t i = 0; i < rows; ++i) {
+            T* c_row = c.row_ptr(i);
+            for (size_t k = 0; k < inner; ++k) {
+                const T a_ik = trans_a ? a(k, i) : a(i, k);
+                if (trans_b) {
+                    for (size_t j = 0; j < cols; ++j) {
+                        c_row[j] += a_ik * b(j, k);
+                    }
+                } else {
+                    const T* b_row = b.row_ptr(k);
+                    for (size_t j = 0; j < cols; ++j) {
+                        c_row[j] += a_ik * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+
+    if (!epilogue.empty()) {
+        epilogue.apply(Kernels::active<T>(), c.data(), c.getStride(), rows, cols);
+    }
+}
+
+// Single-threaded blocked product over the whole of c (shapes already checked)
+// with the given blocking. With packed_b set, b is unused and B panels are read from the prepacked
+// weight instead, whose column b_col0 lines up with c's first column; 16-bit
+// weights are widened into the B buffer one slab at a time.
+template <typename T>
+void gemm_blocked(BasicConstMatrixView<T> a, bool trans_a, BasicConstMatrixView<T> b, bool trans_b,
+                  BasicMatrixView<T> c, bool accumulate, const Epilogue<T>& epilogue, const BlockSizes& bs,
+                  const BasicPackedWeight<T>* packed_b = nullptr, size_t b_col0 = 0) {
+    const size_t M = c.getRows();
+    const size_t N = c.getCols();
+    const size_t K = op_cols(a, trans_a);
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const size_t MR = kernels.gemm_mr;
+    const size_t NR = kernels.gemm_nr;
+
+    PackBuffer<T>& a_pack = a_pack_buffer<T>();
+    PackBuffer<T>& b_pack = b_pack_buffer<T>();
+    a_pack.resize(((bs.mc + MR - 1) / MR) * MR * bs.kc);
+    const bool widen_b = packed_b && packed_b->getStorage() != WeightStorage::Native;
+    if (!packed_b || widen_b) {
+        b_pack.resize(bs.kc * ((bs.nc + NR - 1) / NR) * NR);
+    }
+
+    for (size_t jc = 0; jc < N; jc += bs.nc) {
+        const size_t nc = std::min(bs.nc, N - jc);
+
+        for (size_t pc = 0; pc < K; pc += bs.kc) {
+            const size_t kc = std::min(bs.kc, K - pc);
+            // Only the first slab may overwrite c; later slabs add their partial sums
+            const bool acc = accumulate || pc > 0;
+            // The epilogue runs on each mc x nc block of c right after its last
+            // slab, while the block is still cache resident
+            const bool last_slab = pc + kc == K;
+            if (!packed_b) {
+                pack_b(b, trans_b, pc, jc, kc, nc, NR, b_pack.data());
+            } else if (widen_b) {
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    packed_b->widen_panel(b_col0 + jc + jr, pc, b_pack.data() + jr * kc);
+                }
+            }
+
+            for (size_t ic = 0; ic < M; ic += bs.mc) {
+                const size_t mc = std::min(bs.mc, M - ic);
+                pack_a(a, trans_a, ic, pc, mc, kc, MR, a_pack.data());
+
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    const size_t n = std::min(NR, nc - jr);
+                    const T* b_panel = packed_b && !widen_b ? packed_b->panel(b_col0 + jc + jr, pc)
+                                                            : b_pack.data() + jr * kc;
+
+                    for (size_t ir = 0; ir < mc; ir += MR) {
+                        const size_t m = std::min(MR, mc - ir);
+                        const T* a_panel = a_pack.data() + ir * kc;
+                        T* c_tile = c.row_ptr(ic + ir) + jc + jr;
+                        kernels.gemm_micro(kc, a_panel, b_panel, c_tile, c.getStride(), m, n, acc);
+                    }
+                }
+                if (last_slab && !epilogue.empty()) {
+                    epilogue.shifted(jc).apply(kernels, c.row_ptr(ic) + jc, c.getStride(), mc, nc);
+                }
+            }
+        }
+    }
+}
+
+// Split an M x N product into a grid of independent tiles and run
+// tile(i0, i1, j0, j1) for each on the thread pool. Columns are split first
+// (B, usually the weights, is the larger operand to pack), then rows; tile
+// edges fall on mr x nr micro-tile boundaries. max_threads (tuned) caps the
+// split; 0 leaves it to the flop heuristic.
+template <typename Tile>
+void for_each_tile(size_t M, size_t N, size_t K, size_t mr, size_t nr, size_t max_threads, const Tile& tile) {
+    ThreadPool& pool = ThreadPool::global();
+    const size_t row_panels = (M + mr - 1) / mr;
+    const size_t col_panels = (N + nr - 1) / nr;
+    const size_t threads = max_threads != 0 ? std::min(pool.getNumThreads(), max_threads)
+                                            : std::min(pool.getNumThreads(), M * N * K / kParallelFlopsPerThread);
+    const size_t col_tiles = std::max<size_t>(1, std::min(threads, col_panels));
+    const size_t row_tiles = std::max<size_t>(1, std::min((threads + col_tiles - 1) / col_tiles, row_panels));
+    const size_t tiles = row_tiles * col_tiles;
+
+    if (tiles == 1) {
+        tile(0, M, 0, N);
+        return;
+    }
+
+    // Every tile is already worth a thread, so each counts as a full serial cutoff
+    pool.parallel_for(tiles, ThreadPool::kSerialCutoff, [&](size_t begin, size_t end) {
+        if (begin == 0 && end == tiles) {
+            // Run inline (nested call): no point re-packing per tile
+            tile(0, M, 0, N);
+            return;
+        }
+        for (size_t t = begin; t < end; ++t) {
+            const size_t ti = t / col_tiles;
+            const size_t tj = t % col_tiles;
+            const size_t i0 = std::min(M, ti * row_panels / row_tiles * mr);
+            const size_t i1 = std::min(M, (ti + 1) * row_panels / row_tiles * mr);
+            const size_t j0 = std::min(N, tj * col_panels / col_tiles * nr);
+            const size_t j1 = std::min(N, (tj + 1) * col_panels / col_tiles * nr);
+            if (i0 != i1 && j0 != j1) {
+                tile(i0, i1, j0, j1);
+            }
+        }
+    });
+}
+
+template <typename T>
+void gemm_impl(BasicConstMatrixView<T> a, bool trans_a, BasicConstMatrixView<T> b, bool trans_b,
+               BasicMatrixView<T> c, bool accumulate, const Epilogue<T>& epilogue = {}) {
+    check_shapes(a, trans_a, b, trans_b, c);
+
+    const size_t M = c.getRows();
+    const size_t N = c.getCols();
+    const size_t K = op_cols(a, trans_a);
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+    if (K == 0 || M * N * K < kSmallProblemFlops) {
+        gemm_reference_impl(a, trans_a, b, trans_b, c, accumulate, epilogue);
+        return;
+    }
+
+    // Each tile is a complete blocked product packing its own panels in
+    // thread-local buffers
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const GemmConfig config = config_for(M, N, K, sizeof(T));
+    for_each_tile(M, N, K, kernels.gemm_mr, kernels.gemm_nr, config.threads,
+                  [&](size_t i0, size_t i1, size_t j0, size_t j1) {
+        BasicConstMatrixView<T> a_rows = trans_a ? a.block(0, i0, K, i1 - i0) : a.block(i0, 0, i1 - i0, K);
+        BasicConstMatrixView<T> b_cols = trans_b ? b.block(j0, 0, j1 - j0, K) : b.block(0, j0, K, j1 - j0);
+        gemm_blocked(a_rows, trans_a, b_cols, trans_b, c.block(i0, j0, i1 - i0, j1 - j0), accumulate,
+                     epilogue.shifted(j0), config.blocks);
+    });
+}
+
+template <typename T>
+void gemm_batched_impl(size_t batch, BasicConstMatrixView<T> a, size_t stride_a, bool trans_a,
+                       BasicConstMatrixView<T> b, size_t stride_b, bool trans_b,
+                       BasicMatrixView<T> c, size_t stride_c, bool accumulate) {
+    check_shapes(a, trans_a, b, trans_b, c);
+    check_batch_items(batch, a, stride_a);
+    check_batch_items(batch, b, stride_b);
+    check_batch_items<T>(batch, c, stride_c);
+    // The c_i are written in parallel, so they must not overlap
+    const bool disjoint = stride_c < c.getStride() ? stride_c >= c.getCols()
+                                                   : stride_c >= c.getRows() * c.getStride();
+    if (batch > 1 && c.size() != 0 && !disjoint) {
+        throw std::invalid_argument("Batched output items overlap");
+    }
+
+    const size_t flops = c.getRows() * c.getCols() * op_cols(a, trans_a);
+    auto run_items = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            gemm_impl(BasicConstMatrixView<T>(a.data() + i * stride_a, a.getRows(), a.getCols(), a.getStride()),
+                      trans_a,
+                      BasicConstMatrixView<T>(b.data() + i * stride_b, b.getRows(), b.getCols(), b.getStride()),
+                      trans_b,
+                      BasicMatrixView<T>(c.data() + i * stride_c, c.getRows(), c.getCols(), c.getStride()),
+                      accumulate);
+        }
+    };
+
+    // Items are split between threads in groups worth waking a thread for; a
+    // single group runs here, where each item may still use the pool itself
+    ThreadPool& pool = ThreadPool::global();
+    const size_t groups = std::min({batch, pool.getNumThreads(),
+                                    std::max<size_t>(1, batch * flops / kParallelFlopsPerThread)});
+    if (groups <= 1) {
+        run_items(0, batch);
+        return;
+    }
+    pool.parallel_for(groups, ThreadPool::kSerialCutoff, [&](size_t begin, size_t end) {
+        run_items(begin * batch / groups, end * batch / groups);
+    });
+}
+
+template <typename T>
+BasicConstMatrixView<T> checked_bias(BasicConstMatrixView<T> bias, size_t N) {
+    if (bias.size() != 0 && (bias.size() != N || !bias.isContiguous())) {
+        throw std::invalid_argument("Bias must be a row vector matching the output width");
+    }
+    return bias;
+}
+
+template <typename T>
+void linear_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b, BasicConstMatrixView<T> bias,
+                 BasicMatrixView<T> c, Activation activation, bool trans_b) {
+    checked_bias(bias, trans_b ? b.getRows() : b.getCols());
+    const Epilogue<T> epilogue{bias.size() != 0 ? bias.data() : nullptr, activation};
+    gemm_impl(a, false, b, trans_b, c, false, epilogue);
+}
+
+template <typename T>
+void linear_packed_impl(BasicConstMatrixView<T> a, const BasicPackedWeight<T>& b, BasicConstMatrixView<T> bias,
+                        BasicMatrixView<T> c, Activation activation, size_t b_col0) {
+    const size_t M = c.getRows();
+    const size_t N = c.getCols();
+    const size_t K = a.getCols();
+    if (K != b.getRows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (M != a.getRows() || b_col0 + N > b.getCols()) {
+        throw std::invalid_argument("Output dimensions incompatible for multiplication");
+    }
+    checked_bias(bias, N);
+    const Epilogue<T> epilogue{bias.size() != 0 ? bias.data() : nullptr, activation};
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    if (!b.matches(kernels.gemm_nr)) {
+        // Packed for another kernel table: correct but slow
+        const BasicMatrix<T> plain = b.unpack();
+        gemm_impl(a, false, plain.view().block(0, b_col0, K, N), false, c, false, epilogue);
+        return;
+    }
+    if (b_col0 % kernels.gemm_nr != 0) {
+        throw std::invalid_argument("Packed weight columns must start on a panel boundary");
+    }
+    if (M == 0 || N == 0) {
+        return;
+    }
+    if (K == 0) {
+        gemm_reference_impl(a, false, BasicConstMatrixView<T>(nullptr, 0, N), false, c, false, epilogue);
+        return;
+    }
+
+    // B needs no packing, so even tiny products take the blocked path. The
+    // weight's slabs fix kc and nc; only mc and the split follow the tuning.
+    const GemmConfig config = config_for(M, N, K, sizeof(T));
+    const BlockSizes bs{config.blocks.mc, b.getKc(), b.getNc()};
+    for_each_tile(M, N, K, kernels.gemm_mr, kernels.gemm_nr, config.threads,
+                  [&](size_t i0, size_t i1, size_t j0, size_t j1) {
+        gemm_blocked(a.block(i0, 0, i1 - i0, K), false, BasicConstMatrixView<T>(), false,
+                     c.block(i0, j0, i1 - i0, j1 - j0), false, epilogue.shifted(j0), bs, &b, b_col0 + j0);
+    });
+}
+
+template <typename T>
+void linear_int8_impl(BasicConstMatrixView<T> a, float a_scale, const QuantizedWeight& b,
+                      BasicConstMatrixView<T> bias, BasicMatrixView<T> c, Activation activation, size_t b_col0) {
+    const size_t M = c.getRows();
+    const size_t N = c.getCols();
+    const size_t K = a.getCols();
+    if (K != b.getRows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (M != a.getRows() || b_col0 + N > b.getCols()) {
+        throw std::invalid_argument("Output dimensions incompatible for multiplication");
+    }
+    if (b_col0 % QuantizedWeight::kPanelWidth != 0) {
+        throw std::invalid_argument("Int8 weight columns must start on a panel boundary");
+    }
+    if (!(a_scale > 0.0f)) {
+        throw std::invalid_argument("Int8 input scale must be positive (calibrate first)");
+    }
+    checked_bias(bias, N);
+    const Epilogue<T> epilogue{bias.size() != 0 ? bias.data() : nullptr, activation};
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    // Quantize the input once, rows zero-padded to the weight's k groups;
+    // every tile reads it
+    const size_t depth = b.getDepth();
+    PackBuffer<int8_t>& a_int8 = a_pack_buffer<int8_t>();
+    a_int8.assign(M * depth, 0);
+    const float inv_scale = 1.0f / a_scale;
+    for (size_t i = 0; i < M; ++i) {
+        const T* src = a.row_ptr(i);
+        int8_t* dst = a_int8.data() + i * depth;
+        for (size_t p = 0; p < K; ++p) {
+            dst[p] = quantize_int8(static_cast<float>(src[p]) * inv_scale);
+        }
+    }
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    const auto gemm_int8 = Kernels::active_set().gemm_int8;
+    const size_t nr = QuantizedWeight::kPanelWidth;
+    for_each_tile(M, N, K, kInt8RowBlock, nr, 0, [&](size_t i0, size_t i1, size_t j0, size_t j1) {
+        const size_t n = j1 - j0;
+        PackBuffer<int32_t>& acc = a_pack_buffer<int32_t>();
+        acc.resize(kInt8RowBlock * n);
+        for (size_t i = i0; i < i1; i += kInt8RowBlock) {
+            const size_t m = std::min(kInt8RowBlock, i1 - i);
+            gemm_int8(a_int8.data() + i * depth, depth, b.panel(b_col0 + j0), b.getColumnSums() + b_col0 + j0,
+                      acc.data(), n, m, n, depth);
+            for (size_t r = 0; r < m; ++r) {
+                T* c_row = c.row_ptr(i + r) + j0;
+                const int32_t* acc_row = acc.data() + r * n;
+                const float* scales = b.getScales() + b_col0 + j0;
+                for (size_t j = 0; j < n; ++j) {
+                    c_row[j] = static_cast<T>(static_cast<float>(acc_row[j]) * (a_scale * scales[j]));
+                }
+            }
+            if (!epilogue.empty()) {
+                epilogue.shifted(j0).apply(kernels, c.row_ptr(i) + j0, c.getStride(), m, n);
+            }
+        }
+    });
+}
+
+} // namespace
+
+const BlockSizes& block_sizes() {
+    // A block: 96 x 256 doubles = 192 KiB (L2); B slab: 256 x 2048 = 4 MiB (L3);
+    // an A and a B micro-panel stay within L1 for every MR x NR up to 8 x 16
+    static const BlockSizes sizes{96, 256, 2048};
+    return sizes;
+}
+
+void linear_int8(ConstMatrixView a, float a_scale, const QuantizedWeight& b, ConstMatrixView bias,
+                 MatrixView c, Activation activation, size_t b_col0) {
+    linear_int8_impl(a, a_scale, b, bias, c, activation, b_col0);
+}
+
+void linear_int8(ConstMatrixViewF a, float a_scale, const QuantizedWeight& b, ConstMatrixViewF bias,
+                 MatrixViewF c, Activation activation, size_t b_col0) {
+    linear_int8_impl(a, a_scale, b, bias, c, activation, b_col0);
+}
+
+void gemm_reference(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate) {
+    gemm_reference_impl(a, false, b, false, c, accumulate);
+}
+
+void gemm_reference(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate) {
+    gemm_reference_impl(a, false, b, false, c, accumulate);
+}
+
+void gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate) {
+    gemm_impl(a, false, b, false, c, accumulate);
+}
+
+void gemm(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate) {
+    gemm_impl(a, false, b, false, c, accumulate);
+}
+
+void gemm_nt(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate) {
+    gemm_impl(a, false, b, true, c, accumulate);
+}
+
+void gemm_nt(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate) {
+    gemm_impl(a, false, b, true, c, accumulate);
+}
+
+void gemm_tn(ConstMatrixView a, ConstMatrixView b, MatrixView c, bool accumulate) {
+    gemm_impl(a, true, b, false, c, accumulate);
+}
+
+void gemm_tn(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF c, bool accumulate) {
+    gemm_impl(a, true, b, false, c, accumulate);
+}
+
+void gemm_batched(size_t batch, ConstMatrixView a, size_t stride_a, bool trans_a,
+                  ConstMatrixView b, size_t stride_b, bool trans_b,
+                  MatrixView c, size_t stride_c, bool accumulate) {
+    gemm_batched_impl(batch, a, stride_a, trans_a, b, stride_b, trans_b, c, stride_c, accumulate);
+}
+
+void gemm_batched(size_t batch, ConstMatrixViewF a, size_t stride_a, bool trans_a,
+                  ConstMatrixViewF b, size_t stride_b, bool trans_b,
+                  MatrixViewF c, size_t stride_c, bool accumulate) {
+    gemm_batched_impl(batch, a, stride_a, trans_a, b, stride_b, trans_b, c, stride_c, accumulate);
+}
+
+void linear(ConstMatrixView a, ConstMatrixView b, ConstMatrixView bias, MatrixView c,
+            Activation activation, bool trans_b) {
+    linear_impl(a, b, bias, c, activation, trans_b);
+}
+
+void linear(ConstMatrixViewF a, ConstMatrixViewF b, ConstMatrixViewF bias, MatrixViewF c,
+            Activation activation, bool trans_b) {
+    linear_impl(a, b, bias, c, activation, trans_b);
+}
+
+void linear(ConstMatrixView a, const PackedWeight& b, ConstMatrixView bias, MatrixView c, Activation activation,
+            size_t b_col0) {
+    linear_packed_impl(a, b, bias, c, activation, b_col0);
+}
+
+void linear(ConstMatrixViewF a, const PackedWeightF& b, ConstMatrixViewF bias, MatrixViewF c,
+            Activation activation, size_t b_col0) {
+    linear_packed_impl(a, b, bias, c, activation, b_col0);
+}
+
+} // namespace Gemm
@@ -0,0 +1,84 @@
+#ifndef GEMM_PACKING_H
+#define GEMM_PACKING_H
+
+// Panel packing shared by the GEMM driver and PackedWeight, which must lay
+// out B exactly as the driver would pack it on the fly.
+
+#include <algorithm>
+#include <cstddef>
+#include "../../include/matrix/matrix_view.h"
+
+namespace Gemm {
+namespace detail {
+
+// Pack an mc x kc block of op(A) into mr-row panels: panel p holds rows
+// [p*mr, p*mr + mr) stored k-major, zero padded past the last row. With
+// trans set, a is stored K x M and logical row i is its column i.
+template <typename T>
+void pack_a(BasicConstMatrixView<T> a, bool trans, size_t row0, size_t col0, size_t mc, size_t kc,
+            size_t mr, T* dst) {
+    const size_t lda = a.getStride();
+    for (size_t i0 = 0; i0 < mc; i0 += mr) {
+        const size_t m = std::min(mr, mc - i0);
+        for (size_t p = 0; p < kc; ++p) {
+            if (trans) {
+                // Stored row col0 + p holds the panel's k-th column contiguously
+                const T* src = a.row_ptr(col0 + p) + row0 + i0;
+                for (size_t i = 0; i < m; ++i) {
+                    dst[i] = src[i];
+                }
+            } else {
+                const T* src = a.row_ptr(row0 + i0) + col0 + p;
+                for (size_t i = 0; i < m; ++i) {
+                    dst[i] = src[i * lda];
+                }
+            }
+            for (size_t i = m; i < mr; ++i) {
+                dst[i] = T(0);
+            }
+            dst += mr;
+        }
+    }
+}
+
+// Pack a kc x nc block of op(B) into nr-column panels: panel q holds columns
+// [q*nr, q*nr + nr) stored k-major, zero padded past the last column. With
+// trans set, b is stored N x K and logical column j is its row j.
+template <typename T>
+void pack_b(BasicConstMatrixView<T> b, bool trans, size_t row0, size_t col0, size_t kc, size_t nc,
+            size_t nr, T* dst) {
+    for (size_t j0 = 0; j0 < nc; j0 += nr) {
+        const size_t n = std::min(nr, nc - j0);
+        if (trans) {
+            // Walk each stored row once and scatter it down the panel
+            for (size_t j = 0; j < n; ++j) {
+                const T* src = b.row_ptr(col0 + j0 + j) + row0;
+                for (size_t p = 0; p < kc; ++p) {
+                    dst[p * nr + j] = src[p];
+                }
+            }
+            for (size_t p = 0; p < kc; ++p) {
+                for (size_t j = n; j < nr; ++j) {
+                    dst[p * nr + j] = T(0);
+                }
+            }
+            dst += kc * nr;
+            continue;
+        }
+        for (size_t p = 0; p < kc; ++p) {
+            const T* src = b.row_ptr(row0 + p) + col0 + j0;
+            for (size_t j = 0; j < n; ++j) {
+                dst[j] = src[j];
+            }
+            for (size_t j = n; j < nr; ++j) {
+                dst[j] = T(0);
+            }
+            dst += nr;
+        }
+    }
+}
+
+} // namespace detail
+} // namespace Gemm
+
+#endif //GEMM_PACKING_H
@@ -0,0 +1,355 @@
+#include "../../include/matrix/gemm_tuning.h"
+#include "../../include/matrix/attention.h"
+#include "../../include/matrix/kernels.h"
+#include "../../include/matrix/matrix.h"
+#include "../../include/matrix/packed_weight.h"
+#include "../../include/utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+namespace Gemm {
+
+namespace {
+
+// Tuned mc must stay a multiple of every micro-kernel's MR (4, 6, 8) and nc
+// of every NR (8, 16, 32), so entries hold whichever table is active
+constexpr size_t kMcGranularity = 24;
+constexpr size_t kNcGranularity = 32;
+
+using Key = std::tuple<size_t, size_t, size_t, size_t>;  // element size, m, n, k
+
+struct Entry {
+    bool packed_b;
+    GemmConfig config;
+};
+
+using Entries = std::map<Key, Entry>;
+
+// config_for() runs on every GEMM, attention tiles on pool workers included,
+// so lookups take no lock: the current entries are immutable and published
+// through an atomic pointer. Writers (loads, one per tuned shape) copy them
+// under the mutex and publish the copy. Superseded versions stay alive, as a
+// reader may still be looking at one.
+struct Table {
+    std::atomic<const Entries*> current{nullptr};
+    std::mutex mutex;
+    std::vector<std::unique_ptr<const Entries>> versions;
+};
+
+bool read_tuning(const std::string& path, Entries& entries);
+
+// Caller holds t.mutex
+void publish(Table& t, Entries entries) {
+    t.versions.push_back(std::make_unique<const Entries>(std::move(entries)));
+    t.current.store(t.versions.back().get(), std::memory_order_release);
+}
+
+// Loaded from VIT_GEMM_TUNING on first use, like VIT_ISA for the kernels
+Table& table() {
+    static Table instance;
+    static std::once_flag loaded;
+    std::call_once(loaded, [] {
+        const char* path = std::getenv("VIT_GEMM_TUNING");
+        Entries entries;
+        if (!(path && read_tuning(path, entries))) {
+            entries.clear();
+        }
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        publish(instance, std::move(entries));
+    });
+    return instance;
+}
+
+const Entries& entries() {
+    return *table().current.load(std::memory_order_acquire);
+}
+
+// Copy of the current entries, changed by edit and published
+template <typename Edit>
+void update(const Edit& edit) {
+    Table& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    Entries next = *t.current.load(std::memory_order_relaxed);
+    edit(next);
+    publish(t, std::move(next));
+}
+
+// Config under trial by tune_shape() on this thread, seen before the table
+// so that candidates are not published
+struct Trial {
+    Key key;
+    Entry entry;
+};
+thread_local const Trial* trial = nullptr;
+
+struct TrialScope {
+    explicit TrialScope(const Trial& t) { trial = &t; }
+    ~TrialScope() { trial = nullptr; }
+    TrialScope(const TrialScope&) = delete;
+    TrialScope& operator=(const TrialScope&) = delete;
+};
+
+std::string cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            const size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                return line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+        }
+    }
+    return "unknown";
+}
+
+bool read_tuning(const std::string& path, Entries& entries) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != "host " + tuning_host_key()) {
+        return false;
+    }
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string tag;
+        size_t element_size, m, n, k, mc, kc, nc, threads;
+        bool packed_b;
+        if (!(fields >> tag >> element_size >> m >> n >> k >> packed_b >> mc >> kc >> nc >> threads) ||
+            tag != "shape" || mc == 0 || mc % kMcGranularity != 0 || kc == 0 || nc == 0 ||
+            nc % kNcGranularity != 0) {
+            return false;
+        }
+        entries[Key{element_size, m, n, k}] = Entry{packed_b, GemmConfig{{mc, kc, nc}, threads}};
+    }
+    return true;
+}
+
+void erase_config(const TuneShape& shape, size_t element_size) {
+    update([&](Entries& next) { next.erase(Key{element_size, shape.m, shape.n, shape.k}); });
+}
+
+// Candidates below extent, plus the first that covers it (larger ones block
+// the same way)
+std::vector<size_t> trim(const std::vector<size_t>& values, size_t extent) {
+    std::vector<size_t> kept;
+    for (size_t v : values) {
+        kept.push_back(v);
+        if (v >= extent) {
+            break;
+        }
+    }
+    return kept;
+}
+
+// Best time of a few batches, each long enough to swamp the clock
+template <typename Run>
+double best_time_us(const Run& run) {
+    run();  // Warm caches and the thread-local pack buffers
+    size_t reps = 1;
+    double best = 0.0;
+    for (int batch = 0; batch < 3; ++batch) {
+        while (true) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < reps; ++r) {
+                run();
+            }
+            const double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            if (us < 1000.0 && reps < (size_t(1) << 20)) {
+                reps *= 2;
+                continue;
+            }
+            best = batch == 0 ? us / reps : std::min(best, us / reps);
+            break;
+        }
+    }
+    return best;
+}
+
+// Time one shape with whatever config the table (or this thread's trial) gives it
+template <typename T>
+double time_shape(const TuneShape& shape) {
+    const BasicMatrix<T> a = BasicMatrix<T>::random(shape.m, shape.k);
+    const BasicMatrix<T> b = shape.trans_b ? BasicMatrix<T>::random(shape.n, shape.k)
+                                           : BasicMatrix<T>::random(shape.k, shape.n);
+    BasicMatrix<T> c(shape.m, shape.n);
+    if (shape.packed_b) {
+        // Packed after the config is installed, so with its kc and nc
+        const BasicPackedWeight<T> packed(b);
+        return best_time_us([&] { linear(a, packed, BasicConstMatrixView<T>(), c); });
+    }
+    if (shape.trans_b) {
+        return best_time_us([&] { gemm_nt(a, b, c); });
+    }
+    return best_time_us([&] { gemm(a, b, c); });
+}
+
+template <typename T>
+TuneResult tune_shape(const TuneShape& shape) {
+    erase_config(shape, sizeof(T));
+    TuneResult result{shape, sizeof(T), GemmConfig{block_sizes(), 0}, time_shape<T>(shape), 0.0};
+    result.tuned_us = result.default_us;
+
+    std::vector<size_t> thread_counts{1};
+    for (size_t t = 2; t < ThreadPool::global().getNumThreads(); t *= 2) {
+        thread_counts.push_back(t);
+    }
+    if (ThreadPool::global().getNumThreads() > 1) {
+        thread_counts.push_back(ThreadPool::global().getNumThreads());
+    }
+
+    for (size_t mc : trim({24, 48, 96, 192}, shape.m)) {
+        for (size_t kc : trim({64, 128, 256, 512}, shape.k)) {
+            for (size_t nc : trim({256, 512, 1024, 2048}, shape.n)) {
+                for (size_t threads : thread_counts) {
+                    const GemmConfig candidate{{mc, kc, nc}, threads};
+                    const Trial candidate_trial{Key{sizeof(T), shape.m, shape.n, shape.k},
+                                                Entry{shape.packed_b, candidate}};
+                    const TrialScope scope(candidate_trial);
+                    const double us = time_shape<T>(shape);
+                    if (us < result.tuned_us) {
+                        result.tuned_us = us;
+                        result.config = candidate;
+                    }
+                }
+            }
+        }
+    }
+    set_config(shape, sizeof(T), result.config);
+    return result;
+}
+
+} // namespace
+
+GemmConfig config_for(size_t m, size_t n, size_t k, size_t element_size) {
+    const Key key{element_size, m, n, k};
+    if (trial && trial->key == key) {
+        return trial->entry.config;
+    }
+    const Entries& current = entries();
+    auto it = current.find(key);
+    return it != current.end() ? it->second.config : GemmConfig{block_sizes(), 0};
+}
+
+BlockSizes packing_blocks_for(size_t n, size_t k, size_t element_size) {
+    if (trial && trial->entry.packed_b && std::get<0>(trial->key) == element_size &&
+        std::get<2>(trial->key) == n && std::get<3>(trial->key) == k) {
+        return trial->entry.config.blocks;
+    }
+    for (const auto& [key, entry] : entries()) {
+        if (entry.packed_b && std::get<0>(key) == element_size && std::get<2>(key) == n && std::get<3>(key) == k) {
+            return entry.config.blocks;
+        }
+    }
+    return block_sizes();
+}
+
+// The products Attention::attention issues for seq_len tokens and heads of
+// head_dim: every tile of query rows against every block of keys (scores =
+// q * k^T) and of values (scores * v). Tiles are block_size() rows, and the
+// last one takes the remainder. The class-token-only block's single-row
+// tiles fall below the blocked path and are left out.
+void add_attention_tiles(std::vector<TuneShape>& shapes, size_t seq_len, size_t head_dim) {
+    for (size_t element_size : {sizeof(double), sizeof(float)}) {
+        const size_t block = Attention::block_size(element_size, head_dim, head_dim);
+        std::vector<size_t> extents{std::min(block, seq_len)};
+        if (seq_len > block && seq_len % block != 0) {
+            extents.push_back(seq_len % block);
+        }
+        for (size_t rows : extents) {
+            for (size_t cols : extents) {
+                for (const TuneShape& tile : {TuneShape{rows, cols, head_dim, false, true},
+                                              TuneShape{rows, head_dim, cols, false, false}}) {
+                    const bool seen = std::any_of(shapes.begin(), shapes.end(), [&](const TuneShape& s) {
+                        return s.m == tile.m && s.n == tile.n && s.k == tile.k && s.trans_b == tile.trans_b;
+                    });
+                    if (!seen) {
+                        shapes.push_back(tile);
+                    }
+                }
+            }
+        }
+    }
+}
+
+const std::vector<TuneShape>& vit_shapes() {
+    // Sequence of 49 patches + class token, embed 256, MLP 1024, 8 heads of 32
+    static const std::vector<TuneShape> shapes = [] {
+        std::vector<TuneShape> vit{
+            {50, 768, 256, true},    // Fused Q, K, V projection
+            {50, 256, 256, true},    // Output projection
+            {50, 1024, 256, true},   // MLP up
+            {50, 256, 1024, true},   // MLP down
+            {1, 10, 256, true},      // Classifier head on the class token
+        };
+        add_attention_tiles(vit, 50, 32);
+        return vit;
+    }();
+    return shapes;
+}
+
+std::vector<TuneResult> autotune(const std::vector<TuneShape>& shapes) {
+    std::vector<TuneResult> results;
+    for (const TuneShape& shape : shapes) {
+        results.push_back(tune_shape<double>(shape));
+        results.push_back(tune_shape<float>(shape));
+    }
+    return results;
+}
+
+void set_config(const TuneShape& shape, size_t element_size, const GemmConfig& config) {
+    update([&](Entries& next) {
+        next[Key{element_size, shape.m, shape.n, shape.k}] = Entry{shape.packed_b, config};
+    });
+}
+
+void clear_tuning() {
+    update([](Entries& next) { next.clear(); });
+}
+
+size_t tuned_shape_count() {
+    return entries().size();
+}
+
+std::string tuning_host_key() {
+    static const std::string model = cpu_model();
+    return model + " (" + Kernels::active_set().name + ")";
+}
+
+bool save_tuning(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "host " << tuning_host_key() << "\n";
+    file << "# element_size m n k packed_b mc kc nc threads\n";
+    for (const auto& [key, entry] : entries()) {
+        const BlockSizes& bs = entry.config.blocks;
+        file << "shape " << std::get<0>(key) << " " << std::get<1>(key) << " " << std::get<2>(key) << " "
+             << std::get<3>(key) << " " << entry.packed_b << " " << bs.mc << " " << bs.kc << " " << bs.nc << " "
+             << entry.config.threads << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool load_tuning(const std::string& path) {
+    Entries loaded;
+    if (!read_tuning(path, loaded)) {
+        return false;
+    }
+    update([&](Entries& next) { next = std::move(loaded); });
+    return true;
+}
+
+} // namespace Gemm
@@ -0,0 +1,115 @@
+#include "../../../include/matrix/kernels.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace Kernels {
+
+namespace {
+
+bool cpu_supports(Isa isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                   __builtin_cpu_supports("f16c");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") &&
+                   __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+    }
+    return false;
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+const KernelSet& set_for(Isa isa) {
+    switch (isa) {
+        case Isa::AVX512: return avx512_kernels();
+        case Isa::AVX2: return avx2_kernels();
+        default: return scalar_kernels();
+    }
+}
+
+// Optional cap from the environment, e.g. VIT_ISA=avx2 on an AVX-512 host
+Isa select_isa() {
+    Isa isa = detect_isa();
+    if (const char* env = std::getenv("VIT_ISA")) {
+        Isa requested = isa;
+        if (std::strcmp(env, "scalar") == 0) {
+            requested = Isa::Scalar;
+        } else if (std::strcmp(env, "avx2") == 0) {
+            requested = Isa::AVX2;
+        } else if (std::strcmp(env, "avx512") == 0) {
+            requested = Isa::AVX512;
+        }
+        if (cpu_supports(requested)) {
+            isa = requested;
+        }
+    }
+    return isa;
+}
+
+std::atomic<const KernelSet*>& current() {
+    static std::atomic<const KernelSet*> set{&set_for(select_isa())};
+    return set;
+}
+
+// VIT_MATH=fast opts in to the polynomial transcendentals
+MathMode select_math_mode() {
+    const char* env = std::getenv("VIT_MATH");
+    return env && std::strcmp(env, "fast") == 0 ? MathMode::Fast : MathMode::Exact;
+}
+
+std::atomic<MathMode>& current_math_mode() {
+    static std::atomic<MathMode> mode{select_math_mode()};
+    return mode;
+}
+
+} // namespace
+
+Isa detect_isa() {
+    if (cpu_supports(Isa::AVX512)) {
+        return Isa::AVX512;
+    }
+    if (cpu_supports(Isa::AVX2)) {
+        return Isa::AVX2;
+    }
+    return Isa::Scalar;
+}
+
+const KernelSet& active_set() {
+    return *current().load(std::memory_order_relaxed);
+}
+
+bool set_isa(Isa isa) {
+    if (!cpu_supports(isa)) {
+        return false;
+    }
+    current().store(&set_for(isa), std::memory_order_relaxed);
+    return true;
+}
+
+MathMode math_mode() {
+    return current_math_mode().load(std::memory_order_relaxed);
+}
+
+void set_math_mode(MathMode mode) {
+    current_math_mode().store(mode, std::memory_order_relaxed);
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::AVX512: return "avx512";
+        case Isa::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+const char* math_mode_name(MathMode mode) {
+    return mode == MathMode::Fast ? "fast" : "exact";
+}
+
+} // namespace Kernels
@@ -0,0 +1,685 @@
+#ifndef KERNEL_TEMPLATES_H
+#define KERNEL_TEMPLATES_H
+
+// Kernel bodies shared by every instruction set. Each kernels_<isa>.cpp
+// defines a vector type V for its ISA and includes this file inside its
+// target region, so the templates below are compiled once per ISA. V provides:
+//
+//   scalar, type, width              element type, register type, lanes
+//   load, store                      unaligned memory access
+//   set1, zero                       broadcast
+//   add, sub, mul, div, min, max     lane-wise arithmetic
+//   fmadd                            a * b + c
+//   round                            to the nearest integer, ties to even
+//   select_lt(a, b, x, y)            a < b ? x : y per lane
+//   pow2i(n)                         2^n for integral n in the normal range
+//   reduce_add, reduce_max           horizontal reductions
+//
+// Since V differs per ISA, every instantiation has a distinct symbol and code
+// compiled for one ISA can never be picked by the linker for another.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "../../../include/matrix/kernels.h"
+
+namespace Kernels {
+namespace detail {
+
+constexpr double kSqrt2OverPi = 0.79788456080286535588;  // sqrt(2 / pi)
+constexpr double kGeluCoeff = 0.044715;
+
+template <typename V, typename T = typename V::scalar>
+void add(const T* a, const T* b, T* out, size_t n) {
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, V::add(V::load(a + i), V::load(b + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+template <typename V, typename T = typename V::scalar>
+void sub(const T* a, const T* b, T* out, size_t n) {
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, V::sub(V::load(a + i), V::load(b + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+template <typename V, typename T = typename V::scalar>
+void mul(const T* a, const T* b, T* out, size_t n) {
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, V::mul(V::load(a + i), V::load(b + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+template <typename V, typename T = typename V::scalar>
+void scale(const T* a, T s, T* out, size_t n) {
+    const typename V::type vs = V::set1(s);
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, V::mul(V::load(a + i), vs));
+    }
+    for (; i < n; ++i) {
+        out[i] = a[i] * s;
+    }
+}
+
+template <typename V, typename T = typename V::scalar>
+void add_scalar(const T* a, T s, T* out, size_t n) {
+    const typename V::type vs = V::set1(s);
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, V::add(V::load(a + i), vs));
+    }
+    for (; i < n; ++i) {
+        out[i] = a[i] + s;
+    }
+}
+
+template <typename V, typename T = typename V::scalar>
+T sum(const T* a, size_t n) {
+    // Two independent accumulators hide the add latency
+    typename V::type acc0 = V::zero();
+    typename V::type acc1 = V::zero();
+    size_t i = 0;
+    for (; i + 2 * V::width <= n; i += 2 * V::width) {
+        acc0 = V::add(acc0, V::load(a + i));
+        acc1 = V::add(acc1, V::load(a + i + V::width));
+    }
+    for (; i + V::width <= n; i += V::width) {
+        acc0 = V::add(acc0, V::load(a + i));
+    }
+    T total = V::reduce_add(V::add(acc0, acc1));
+    for (; i < n; ++i) {
+        total += a[i];
+    }
+    return total;
+}
+
+// out[i] = f(x[i]) a register at a time. The tail goes through a padded
+// buffer so it gets the same approximation as the body; out may alias x.
+template <typename V, typename F, typename T = typename V::scalar>
+void map_vec(const T* x, T* out, size_t n, F f) {
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, f(V::load(x + i)));
+    }
+    if (i < n) {
+        alignas(64) T tail[V::width] = {};
+        std::copy(x + i, x + n, tail);
+        V::store(tail, f(V::load(tail)));
+        std::copy(tail, tail + (n - i), out + i);
+    }
+}
+
+// exp(x) per lane. n = round(x / ln2) and r = x - n * ln2 in two steps
+// (Cody-Waite: the high part of ln2 has few enough bits that n * hi is
+// exact), exp(r) from a polynomial on |r| <= ln2 / 2, then 2^n applied in two
+// halves so results round to subnormals, zero or infinity where libm's do.
+// Float uses the Cephes expf minimax polynomial, double the degree-13 Taylor
+// polynomial (truncation below 1e-17).
+template <typename V, typename T = typename V::scalar>
+inline typename V::type exp_vec(typename V::type x) {
+    using R = typename V::type;
+    constexpr bool single = sizeof(T) == sizeof(float);
+
+    // exp is 0 below lo and infinite above hi; the clamp keeps n in range
+    // and lets NaN through
+    const R lo = V::set1(single ? T(-104) : T(-746));
+    const R hi = V::set1(single ? T(89) : T(710));
+    x = V::max(lo, V::min(hi, x));
+
+    const R n = V::round(V::mul(x, V::set1(T(1.44269504088896340736))));
+    R r;
+    R p;
+    if constexpr (single) {
+        r = V::fmadd(n, V::set1(T(-0.693359375)), x);
+        r = V::fmadd(n, V::set1(T(2.12194440e-4)), r);
+        p = V::set1(T(1.9875691500e-4));
+        p = V::fmadd(p, r, V::set1(T(1.3981999507e-3)));
+        p = V::fmadd(p, r, V::set1(T(8.3334519073e-3)));
+        p = V::fmadd(p, r, V::set1(T(4.1665795894e-2)));
+        p = V::fmadd(p, r, V::set1(T(1.6666665459e-1)));
+        p = V::fmadd(p, r, V::set1(T(5.0000001201e-1)));
+        // 1 + r + r^2 * p
+        p = V::add(V::fmadd(V::mul(p, r), r, r), V::set1(T(1)));
+    } else {
+        r = V::fmadd(n, V::set1(T(-6.93145751953125e-1)), x);
+        r = V::fmadd(n, V::set1(T(-1.42860682030941723212e-6)), r);
+        // 1 / k! for k = 13 down to 0
+        static constexpr double kInvFactorial[] = {
+            1.60590438368216145994e-10, 2.08767569878680989792e-9, 2.50521083854417187751e-8,
+            2.75573192239858906526e-7, 2.75573192239858906526e-6, 2.48015873015873015873e-5,
+            1.98412698412698412698e-4, 1.38888888888888888889e-3, 8.33333333333333333333e-3,
+            4.16666666666666666667e-2, 1.66666666666666666667e-1, 0.5, 1.0, 1.0,
+        };
+        p = V::set1(T(kInvFactorial[0]));
+#pragma GCC unroll 16
+        for (size_t k = 1; k < sizeof(kInvFactorial) / sizeof(kInvFactorial[0]); ++k) {
+            p = V::fmadd(p, r, V::set1(T(kInvFactorial[k])));
+        }
+    }
+
+    const R half_n = V::round(V::mul(n, V::set1(T(0.5))));
+    return V::mul(V::mul(p, V::pow2i(half_n)), V::pow2i(V::sub(n, half_n)));
+}
+
+// tanh(x) per lane. Below |x| = 0.625 the Cephes odd polynomial (float) or
+// rational function (double); above, 1 - 2 / (exp(2|x|) + 1), which loses at
+// most a bit to cancellation there.
+template <typename V, typename T = typename V::scalar>
+typename V::type tanh_vec(typename V::type x) {
+    using R = typename V::type;
+    const R zero = V::zero();
+    const R one = V::set1(T(1));
+    const R abs_x = V::max(x, V::sub(zero, x));
+
+    const R e = exp_vec<V>(V::add(abs_x, abs_x));
+    R large = V::sub(one, V::div(V::set1(T(2)), V::add(e, one)));
+    large = V::select_lt(x, zero, V::sub(zero, large), large);
+
+    const R z = V::mul(x, x);
+    R small;
+    if constexpr (sizeof(T) == sizeof(float)) {
+        R p = V::set1(T(-5.70498872745e-3));
+        p = V::fmadd(p, z, V::set1(T(2.06390887954e-2)));
+        p = V::fmadd(p, z, V::set1(T(-5.37397155531e-2)));
+        p = V::fmadd(p, z, V::set1(T(1.33314422036e-1)));
+        p = V::fmadd(p, z, V::set1(T(-3.33332819422e-1)));
+        small = V::fmadd(V::mul(p, z), x, x);
+    } else {
+        R p = V::set1(T(-9.64399179425052238628e-1));
+        p = V::fmadd(p, z, V::set1(T(-9.92877231001918586564e1)));
+        p = V::fmadd(p, z, V::set1(T(-1.61468768441708447952e3)));
+        R q = V::add(z, V::set1(T(1.12811678491632931402e2)));
+        q = V::fmadd(q, z, V::set1(T(2.23548839060100448583e3)));
+        q = V::fmadd(q, z, V::set1(T(4.84406305325125486048e3)));
+        small = V::fmadd(V::mul(V::div(p, q), z), x, x);
+    }
+    return V::select_lt(abs_x, V::set1(T(0.625)), small, large);
+}
+
+// 1 / (1 + exp(-x)) per lane, as e / (1 + e) with e = exp(x) for negative
+// x so exp never overflows and tiny results keep their precision
+template <typename V, typename T = typename V::scalar>
+typename V::type sigmoid_vec(typename V::type x) {
+    using R = typename V::type;
+    const R zero = V::zero();
+    const R one = V::set1(T(1));
+    const R e = exp_vec<V>(V::sub(zero, V::max(x, V::sub(zero, x))));
+    const R inv = V::div(one, V::add(one, e));
+    return V::select_lt(x, zero, V::mul(e, inv), inv);
+}
+
+// Per-lane operations for map_vec. Function objects rather than lambdas: a
+// lambda's body does not inherit the ISA target of the enclosing region.
+template <typename V>
+struct ExpOp {
+    typename V::type operator()(typename V::type v) const { return exp_vec<V>(v); }
+};
+
+template <typename V>
+struct TanhOp {
+    typename V::type operator()(typename V::type v) const { return tanh_vec<V>(v); }
+};
+
+template <typename V>
+struct SigmoidOp {
+    typename V::type operator()(typename V::type v) const { return sigmoid_vec<V>(v); }
+};
+
+// 0.5 * x * (1 + tanh) = hx + hx * tanh, with tanh argument x * (c0 + c1 * x^2)
+template <typename V>
+struct GeluOp {
+    typename V::type c0, c1, half;
+    typename V::type operator()(typename V::type v) const {
+        const typename V::type hx = V::mul(half, v);
+        const typename V::type t = tanh_vec<V>(V::mul(v, V::fmadd(c1, V::mul(v, v), c0)));
+        return V::fmadd(hx, t, hx);
+    }
+};
+
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+void exp(const T* x, T* out, size_t n) {
+    if constexpr (Mode == MathMode::Fast) {
+        map_vec<V>(x, out, n, ExpOp<V>{});
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::exp(x[i]);
+        }
+    }
+}
+
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+void tanh(const T* x, T* out, size_t n) {
+    if constexpr (Mode == MathMode::Fast) {
+        map_vec<V>(x, out, n, TanhOp<V>{});
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::tanh(x[i]);
+        }
+    }
+}
+
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+void sigmoid(const T* x, T* out, size_t n) {
+    if constexpr (Mode == MathMode::Fast) {
+        map_vec<V>(x, out, n, SigmoidOp<V>{});
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = T(1) / (T(1) + std::exp(-x[i]));
+        }
+    }
+}
+
+// exp per lane in the given math mode
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+typename V::type exp_lanes(typename V::type v) {
+    if constexpr (Mode == MathMode::Fast) {
+        return exp_vec<V>(v);
+    } else {
+        alignas(64) T lanes[V::width];
+        V::store(lanes, v);
+        for (size_t l = 0; l < V::width; ++l) {
+            lanes[l] = std::exp(lanes[l]);
+        }
+        return V::load(lanes);
+    }
+}
+
+// Stores exp(s * x - max) for x[0, n) into out and returns the lane sums. A
+// ragged end is done as the last full vector, read before anything is stored
+// (out may alias x) and with the lanes already done dropped from the sum.
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+typename V::type exp_shifted_block(const T* x, typename V::type s, typename V::type max, T* out, size_t n) {
+    using R = typename V::type;
+    constexpr size_t W = V::width;
+    alignas(64) static constexpr T lane[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    const size_t rem = n % W;
+    R sum = V::zero();
+
+    if (n < W) {
+        alignas(64) T tail[W] = {};
+        std::copy(x, x + n, tail);
+        R e = exp_lanes<V, Mode>(V::sub(V::mul(V::load(tail), s), max));
+        e = V::select_lt(V::load(lane), V::set1(T(n)), e, V::zero());
+        V::store(tail, e);
+        std::copy(tail, tail + n, out);
+        return e;
+    }
+
+    const R last = V::load(x + n - W);
+    for (size_t i = 0; i + W <= n; i += W) {
+        const R e = exp_lanes<V, Mode>(V::sub(V::mul(V::load(x + i), s), max));
+        V::store(out + i, e);
+        sum = V::add(sum, e);
+    }
+    if (rem != 0) {
+        const R e = exp_lanes<V, Mode>(V::sub(V::mul(last, s), max));
+        V::store(out + n - W, e);
+        sum = V::add(sum, V::select_lt(V::load(lane), V::set1(T(W - rem)), V::zero(), e));
+    }
+    return sum;
+}
+
+// Max of init and s * x[i] over [0, n); a ragged end is covered by an
+// overlapping last vector
+template <typename V, typename T = typename V::scalar>
+T scaled_max(const T* x, T s, size_t n, T init) {
+    using R = typename V::type;
+    constexpr size_t W = V::width;
+    const R vscale = V::set1(s);
+    R m = V::set1(init);
+    for (size_t i = 0; i + W <= n; i += W) {
+        m = V::max(m, V::mul(V::load(x + i), vscale));
+    }
+    T result = V::reduce_max(m);
+    if (n % W != 0) {
+        if (n >= W) {
+            result = std::max(result, V::reduce_max(V::mul(V::load(x + n - W), vscale)));
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                result = std::max(result, x[i] * s);
+            }
+        }
+    }
+    return result;
+}
+
+// softmax(s * x) with the online max / sum formulation, over blocks small
+// enough to stay in L1: each block is read for its max and then again to
+// store exp(s * x - running max) and add to the sum. When a block raises the
+// running max the sum so far is rescaled and a new segment of stored values
+// starts; the normalize pass multiplies each segment by
+// exp(segment max - row max) / sum. Nothing is allocated; out may alias x.
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+void softmax_row(const T* x, T s, T* out, size_t n) {
+    using R = typename V::type;
+    constexpr size_t kBlock = 2048 / sizeof(T);
+    constexpr size_t kMaxSegments = 16;
+    const R vscale = V::set1(s);
+
+    size_t segment_begin[kMaxSegments];
+    T segment_max[kMaxSegments];
+    size_t segments = 0;
+    T row_max = -std::numeric_limits<T>::infinity();
+    T row_sum = T(0);
+
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t len = std::min(kBlock, n - base);
+        const T* block = x + base;
+
+        const T block_max = scaled_max<V>(block, s, len, row_max);
+        if (block_max > row_max) {
+            if (segments > 0) {
+                row_sum *= std::exp(row_max - block_max);
+            }
+            row_max = block_max;
+            if (segments == kMaxSegments) {
+                // Out of segments: bring everything stored so far to this max
+                for (size_t g = 0; g < segments; ++g) {
+                    const size_t stop = g + 1 < segments ? segment_begin[g + 1] : base;
+                    scale<V>(out + segment_begin[g], std::exp(segment_max[g] - row_max),
+                             out + segment_begin[g], stop - segment_begin[g]);
+                }
+                segments = 0;
+                segment_begin[segments] = 0;
+            } else {
+                segment_begin[segments] = base;
+            }
+            segment_max[segments++] = row_max;
+        }
+
+        row_sum += V::reduce_add(exp_shifted_block<V, Mode>(block, vscale, V::set1(row_max), out + base, len));
+    }
+
+    // The last segment is already relative to the row max
+    const T inv_sum = T(1) / row_sum;
+    for (size_t g = 0; g < segments; ++g) {
+        const size_t stop = g + 1 < segments ? segment_begin[g + 1] : n;
+        const T factor = g + 1 < segments ? std::exp(segment_max[g] - row_max) * inv_sum : inv_sum;
+        scale<V>(out + segment_begin[g], factor, out + segment_begin[g], stop - segment_begin[g]);
+    }
+}
+
+// One block of a row of an online softmax: raises *max to cover s * x,
+// rescales *sum to it and adds the block's exponentials, which replace x
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+T softmax_block(T* x, T s, size_t n, T* max, T* sum) {
+    const T block_max = scaled_max<V>(x, s, n, *max);
+    T factor = T(1);
+    if (block_max > *max) {
+        // Nothing accumulated yet when the old max is -inf
+        factor = *max == -std::numeric_limits<T>::infinity() ? T(0) : std::exp(*max - block_max);
+        *sum *= factor;
+        *max = block_max;
+    }
+    *sum += V::reduce_add(exp_shifted_block<V, Mode>(x, V::set1(s), V::set1(*max), x, n));
+    return factor;
+}
+
+template <typename V, MathMode Mode, typename T = typename V::scalar>
+void gelu(const T* x, T* out, size_t n) {
+    // tanh approximation: 0.5 * x * (1 + tanh(sqrt(2/pi) * (x + 0.044715 * x^3))).
+    const T s0 = T(kSqrt2OverPi);
+    const T s1 = T(kSqrt2OverPi * kGeluCoeff);
+    const typename V::type c0 = V::set1(s0);
+    const typename V::type c1 = V::set1(s1);
+    const typename V::type half = V::set1(T(0.5));
+
+    if constexpr (Mode == MathMode::Fast) {
+        map_vec<V>(x, out, n, GeluOp<V>{c0, c1, half});
+        return;
+    }
+
+    // Libm tanh: works in chunks through a stack buffer so out may alias x
+    constexpr size_t chunk = 256;
+    alignas(64) T t[chunk];
+
+    for (size_t base = 0; base < n; base += chunk) {
+        const size_t len = std::min(chunk, n - base);
+        const T* xs = x + base;
+        T* os = out + base;
+
+        // tanh argument: x * (c0 + c1 * x^2)
+        size_t i = 0;
+        for (; i + V::width <= len; i += V::width) {
+            typename V::type v = V::load(xs + i);
+            typename V::type x2 = V::mul(v, v);
+            V::store(t + i, V::mul(v, V::fmadd(c1, x2, c0)));
+        }
+        for (; i < len; ++i) {
+            t[i] = xs[i] * (s0 + s1 * xs[i] * xs[i]);
+        }
+
+        for (i = 0; i < len; ++i) {
+            t[i] = std::tanh(t[i]);
+        }
+
+        // 0.5 * x * (1 + tanh) = hx + hx * tanh
+        for (i = 0; i + V::width <= len; i += V::width) {
+            typename V::type hx = V::mul(half, V::load(xs + i));
+            V::store(os + i, V::fmadd(hx, V::load(t + i), hx));
+        }
+        for (; i < len; ++i) {
+            os[i] = T(0.5) * xs[i] * (T(1) + t[i]);
+        }
+    }
+}
+
+// Element sources for mean_variance: a row as is, or the sum of two rows,
+// written out as it is read
+template <typename V, typename T = typename V::scalar>
+struct RowSource {
+    const T* x;
+    typename V::type load(size_t i) const { return V::load(x + i); }
+    T at(size_t i) const { return x[i]; }
+};
+
+template <typename V, typename T = typename V::scalar>
+struct SumSource {
+    const T* a;
+    const T* b;
+    T* sum;
+    typename V::type load(size_t i) const {
+        const typename V::type v = V::add(V::load(a + i), V::load(b + i));
+        V::store(sum + i, v);
+        return v;
+    }
+    T at(size_t i) const {
+        sum[i] = a[i] + b[i];
+        return sum[i];
+    }
+};
+
+// Mean and (population) variance of a row in one pass. Welford's update runs
+// in every lane of four independent streams, so consecutive updates do not
+// wait on each other. The streams hold equal counts and merge with Chan's
+// formula, leftover vectors and then leftover elements continue Welford on
+// the result, and the lanes (again equal counts) merge the same way.
+template <typename V, typename Source, typename T = typename V::scalar>
+void mean_variance(const Source& x, size_t n, T& mean, T& variance) {
+    using R = typename V::type;
+    constexpr size_t W = V::width;
+    constexpr size_t S = 4;
+    const size_t vectors = n / W;
+    const size_t steps = vectors / S;
+    T m = T(0);
+    T m2 = T(0);
+
+    if (steps > 0) {
+        R means[S];
+        R m2s[S];
+#pragma GCC unroll 4
+        for (size_t s = 0; s < S; ++s) {
+            means[s] = x.load(s * W);
+            m2s[s] = V::zero();
+        }
+        for (size_t k = 1; k < steps; ++k) {
+            const R inv_count = V::set1(T(1) / T(k + 1));
+#pragma GCC unroll 4
+            for (size_t s = 0; s < S; ++s) {
+                const R v = x.load((k * S + s) * W);
+                const R delta = V::sub(v, means[s]);
+                means[s] = V::fmadd(delta, inv_count, means[s]);
+                m2s[s] = V::fmadd(delta, V::sub(v, means[s]), m2s[s]);
+            }
+        }
+
+        // Equal counts: the mean of the means, plus their spread
+        R lane_mean = V::mul(V::add(V::add(means[0], means[1]), V::add(means[2], means[3])), V::set1(T(1) / T(S)));
+        R spread = V::zero();
+        R lane_m2 = V::add(V::add(m2s[0], m2s[1]), V::add(m2s[2], m2s[3]));
+#pragma GCC unroll 4
+        for (size_t s = 0; s < S; ++s) {
+            const R d = V::sub(means[s], lane_mean);
+            spread = V::fmadd(d, d, spread);
+        }
+        lane_m2 = V::fmadd(spread, V::set1(T(steps)), lane_m2);
+
+        for (size_t j = steps * S; j < vectors; ++j) {
+            const R v = x.load(j * W);
+            const R delta = V::sub(v, lane_mean);
+            lane_mean = V::fmadd(delta, V::set1(T(1) / T(j + 1)), lane_mean);
+            lane_m2 = V::fmadd(delta, V::sub(v, lane_mean), lane_m2);
+        }
+
+        m = V::reduce_add(lane_mean) / T(W);
+        const R d = V::sub(lane_mean, V::set1(m));
+        m2 = V::reduce_add(V::fmadd(V::mul(d, d), V::set1(T(vectors)), lane_m2));
+    }
+
+    for (size_t i = steps > 0 ? vectors * W : 0; i < n; ++i) {
+        const T v = x.at(i);
+        const T delta = v - m;
+        m += delta / T(i + 1);
+        m2 += delta * (v - m);
+    }
+    mean = m;
+    variance = m2 / static_cast<T>(n);
+}
+
+// out = gamma * (x - mean) * inv_std + beta
+template <typename V, typename T = typename V::scalar>
+void normalize_row(const T* x, T mean, T inv_std, const T* gamma, const T* beta, T* out, size_t n) {
+    const typename V::type vmean = V::set1(mean);
+    const typename V::type vinv = V::set1(inv_std);
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        typename V::type normalized = V::mul(V::sub(V::load(x + i), vmean), vinv);
+        V::store(out + i, V::fmadd(V::load(gamma + i), normalized, V::load(beta + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] = gamma[i] * ((x[i] - mean) * inv_std) + beta[i];
+    }
+}
+
+template <typename V, typename T = typename V::scalar>
+void layer_norm_row(const T* x, const T* gamma, const T* beta,
+                    T epsilon, T* out, size_t n) {
+    T mean, variance;
+    mean_variance<V>(RowSource<V>{x}, n, mean, variance);
+    normalize_row<V>(x, mean, T(1) / std::sqrt(variance + epsilon), gamma, beta, out, n);
+}
+
+template <typename V, typename T = typename V::scalar>
+void add_layer_norm_row(const T* a, const T* b, const T* gamma, const T* beta,
+                        T epsilon, T* sum, T* out, size_t n) {
+    // The statistics pass writes the sum; normalizing re-reads it from L1
+    T mean, variance;
+    mean_variance<V>(SumSource<V>{a, b, sum}, n, mean, variance);
+    normalize_row<V>(sum, mean, T(1) / std::sqrt(variance + epsilon), gamma, beta, out, n);
+}
+
+// MR x (NV * width) register tile over packed panels (see Gemm::gemm)
+template <typename V, size_t MR, size_t NV, typename T = typename V::scalar>
+void gemm_micro(size_t kc, const T* a_panel, const T* b_panel,
+                T* c, size_t ldc, size_t m, size_t n, bool accumulate) {
+    constexpr size_t W = V::width;
+    constexpr size_t NR = NV * W;
+
+    typename V::type acc[MR][NV];
+#pragma GCC unroll 16
+    for (size_t i = 0; i < MR; ++i) {
+#pragma GCC unroll 16
+        for (size_t j = 0; j < NV; ++j) {
+            acc[i][j] = V::zero();
+        }
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        const T* a = a_panel + p * MR;
+        const T* b = b_panel + p * NR;
+        typename V::type bv[NV];
+#pragma GCC unroll 16
+        for (size_t j = 0; j < NV; ++j) {
+            bv[j] = V::load(b + j * W);
+        }
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i) {
+            const typename V::type ai = V::set1(a[i]);
+#pragma GCC unroll 16
+            for (size_t j = 0; j < NV; ++j) {
+                acc[i][j] = V::fmadd(ai, bv[j], acc[i][j]);
+            }
+        }
+    }
+
+    if (m == MR && n == NR) {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i) {
+#pragma GCC unroll 16
+            for (size_t j = 0; j < NV; ++j) {
+                T* dst = c + i * ldc + j * W;
+                V::store(dst, accumulate ? V::add(V::load(dst), acc[i][j]) : acc[i][j]);
+            }
+        }
+        return;
+    }
+
+    // Edge tile: spill the registers and copy only the valid part
+    alignas(64) T tile[MR * NR];
+    for (size_t i = 0; i < MR; ++i) {
+        for (size_t j = 0; j < NV; ++j) {
+            V::store(tile + i * NR + j * W, acc[i][j]);
+        }
+    }
+    for (size_t i = 0; i < m; ++i) {
+        T* dst = c + i * ldc;
+        const T* src = tile + i * NR;
+        for (size_t j = 0; j < n; ++j) {
+            dst[j] = accumulate ? dst[j] + src[j] : src[j];
+        }
+    }
+}
+
+// Table of the kernels above for one vector type, with an MR x (NV * width)
+// GEMM tile and transcendentals in the given math mode
+template <typename V, size_t MR, size_t NV, MathMode Mode, typename T = typename V::scalar>
+KernelTable<T> make_table(Isa isa, const char* name) {
+    return KernelTable<T>{
+        isa, name, Mode,
+        MR, NV * V::width, &gemm_micro<V, MR, NV>,
+        &add<V>, &sub<V>, &mul<V>,
+        &scale<V>, &add_scalar<V>,
+        &sum<V>,
+        &exp<V, Mode>, &tanh<V, Mode>, &sigmoid<V, Mode>,
+        &softmax_row<V, Mode>, &softmax_block<V, Mode>, &gelu<V, Mode>, &layer_norm_row<V>, &add_layer_norm_row<V>,
+    };
+}
+
+} // namespace detail
+} // namespace Kernels
+
+#endif //KERNEL_TEMPLATES_H
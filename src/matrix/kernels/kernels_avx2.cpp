@@ -0,0 +1,220 @@
+#include "../../../include/matrix/kernels.h"
+#include "../../../include/matrix/half.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <immintrin.h>
+
+// Everything defined between push_options and pop_options is compiled for
+// AVX2 + FMA + F16C (Haswell and later) and only reached through the
+// dispatcher.
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c")
+
+namespace Kernels {
+namespace avx2 {
+
+struct VecD {
+    using scalar = double;
+    using type = __m256d;
+    static constexpr size_t width = 4;
+
+    static type load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, type v) { _mm256_storeu_pd(p, v); }
+    static type set1(double x) { return _mm256_set1_pd(x); }
+    static type zero() { return _mm256_setzero_pd(); }
+    static type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm256_div_pd(a, b); }
+    static type min(type a, type b) { return _mm256_min_pd(a, b); }
+    static type max(type a, type b) { return _mm256_max_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+    static type round(type a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static type select_lt(type a, type b, type x, type y) {
+        return _mm256_blendv_pd(y, x, _mm256_cmp_pd(a, b, _CMP_LT_OQ));
+    }
+
+    static type pow2i(type n) {
+        const __m256i e = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)), _mm256_set1_epi64x(1023));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(e, 52));
+    }
+
+    static double reduce_add(type v) {
+        __m128d lo = _mm256_castpd256_pd128(v);
+        __m128d hi = _mm256_extractf128_pd(v, 1);
+        lo = _mm_add_pd(lo, hi);
+        return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    }
+
+    static double reduce_max(type v) {
+        __m128d lo = _mm256_castpd256_pd128(v);
+        __m128d hi = _mm256_extractf128_pd(v, 1);
+        lo = _mm_max_pd(lo, hi);
+        return _mm_cvtsd_f64(_mm_max_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    }
+};
+
+struct VecF {
+    using scalar = float;
+    using type = __m256;
+    static constexpr size_t width = 8;
+
+    static type load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+    static type set1(float x) { return _mm256_set1_ps(x); }
+    static type zero() { return _mm256_setzero_ps(); }
+    static type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm256_div_ps(a, b); }
+    static type min(type a, type b) { return _mm256_min_ps(a, b); }
+    static type max(type a, type b) { return _mm256_max_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+    static type round(type a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static type select_lt(type a, type b, type x, type y) {
+        return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+    }
+
+    static type pow2i(type n) {
+        const __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+    }
+
+    static float reduce_add(type v) {
+        __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+        return _mm_cvtss_f32(_mm_add_ss(lo, _mm_movehdup_ps(lo)));
+    }
+
+    static float reduce_max(type v) {
+        __m128 lo = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+        return _mm_cvtss_f32(_mm_max_ss(lo, _mm_movehdup_ps(lo)));
+    }
+};
+
+// R rows x one 16-column panel of the int8 GEMM. _mm256_maddubs_epi16
+// multiplies unsigned by signed bytes, so the broadcast 4 bytes of a go in as
+// |a| and b takes their signs; with both in [-127, 127] the 16-bit pair sums
+// cannot saturate.
+template <int R>
+void gemm_int8_tile(const int8_t* a, size_t lda, const int8_t* panel, int32_t* c, size_t ldc,
+                    size_t n, size_t k) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc[R][2];
+#pragma GCC unroll 16
+    for (int r = 0; r < R; ++r) {
+        acc[r][0] = acc[r][1] = _mm256_setzero_si256();
+    }
+    for (size_t p = 0; p < k; p += 4) {
+        const __m256i b0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(panel + p * 16));
+        const __m256i b1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(panel + p * 16 + 32));
+#pragma GCC unroll 16
+        for (int r = 0; r < R; ++r) {
+            int32_t quad;
+            std::memcpy(&quad, a + r * lda + p, sizeof(quad));
+            const __m256i va = _mm256_set1_epi32(quad);
+            const __m256i va_abs = _mm256_sign_epi8(va, va);
+            acc[r][0] = _mm256_add_epi32(acc[r][0],
+                                         _mm256_madd_epi16(_mm256_maddubs_epi16(va_abs, _mm256_sign_epi8(b0, va)), ones));
+            acc[r][1] = _mm256_add_epi32(acc[r][1],
+                                         _mm256_madd_epi16(_mm256_maddubs_epi16(va_abs, _mm256_sign_epi8(b1, va)), ones));
+        }
+    }
+#pragma GCC unroll 16
+    for (int r = 0; r < R; ++r) {
+        if (n == 16) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + r * ldc), acc[r][0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + r * ldc + 8), acc[r][1]);
+        } else {
+            alignas(32) int32_t row[16];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(row), acc[r][0]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(row + 8), acc[r][1]);
+            std::memcpy(c + r * ldc, row, n * sizeof(int32_t));
+        }
+    }
+}
+
+void gemm_int8(const int8_t* a, size_t lda, const int8_t* b, const int32_t* /*b_sums*/,
+               int32_t* c, size_t ldc, size_t m, size_t n, size_t k) {
+    for (size_t j = 0; j < n; j += 16) {
+        const int8_t* panel = b + j * k;
+        const size_t cols = std::min<size_t>(16, n - j);
+        size_t i = 0;
+        for (; i + 4 <= m; i += 4) {
+            gemm_int8_tile<4>(a + i * lda, lda, panel, c + i * ldc + j, ldc, cols, k);
+        }
+        switch (m - i) {
+            case 3: gemm_int8_tile<3>(a + i * lda, lda, panel, c + i * ldc + j, ldc, cols, k); break;
+            case 2: gemm_int8_tile<2>(a + i * lda, lda, panel, c + i * ldc + j, ldc, cols, k); break;
+            case 1: gemm_int8_tile<1>(a + i * lda, lda, panel, c + i * ldc + j, ldc, cols, k); break;
+            default: break;
+        }
+    }
+}
+
+void bf16_to_float(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+    }
+    for (; i < n; ++i) {
+        dst[i] = ::bf16_to_float(src[i]);
+    }
+}
+
+void fp16_to_float(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    }
+    for (; i < n; ++i) {
+        dst[i] = ::fp16_to_float(src[i]);
+    }
+}
+
+} // namespace avx2
+} // namespace Kernels
+
+#include "kernel_templates.h"
+
+#pragma GCC pop_options
+
+namespace Kernels {
+
+const KernelSet& avx2_kernels() {
+    // 6 x 8 (double) / 6 x 16 (float) tile: 12 accumulators + 2 B vectors
+    // + 1 broadcast of 16 ymm registers
+    static const KernelSet set{
+        Isa::AVX2, "avx2",
+        detail::make_table<avx2::VecD, 6, 2, MathMode::Fast>(Isa::AVX2, "avx2"),
+        detail::make_table<avx2::VecF, 6, 2, MathMode::Fast>(Isa::AVX2, "avx2"),
+        detail::make_table<avx2::VecD, 6, 2, MathMode::Exact>(Isa::AVX2, "avx2"),
+        detail::make_table<avx2::VecF, 6, 2, MathMode::Exact>(Isa::AVX2, "avx2"),
+        avx2::gemm_int8,
+        avx2::bf16_to_float,
+        avx2::fp16_to_float,
+    };
+    return set;
+}
+
+} // namespace Kernels
+
+#else
+
+namespace Kernels {
+
+// Not an x86 target: the dispatcher never selects this set
+const KernelSet& avx2_kernels() {
+    return scalar_kernels();
+}
+
+} // namespace Kernels
+
+#endif
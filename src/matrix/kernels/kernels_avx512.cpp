@@ -0,0 +1,216 @@
+#include "../../../include/matrix/kernels.h"
+#include "../../../include/matrix/half.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <immintrin.h>
+#include <vector>
+
+// Everything defined between push_options and pop_options is compiled for
+// AVX-512F (Skylake-SP, Ice Lake and later) and only reached through the
+// dispatcher.
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma,f16c")
+// GCC 12's AVX-512 headers self-initialize "undefined" registers, which
+// -Wall reports once the intrinsics are inlined under a target pragma
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+namespace Kernels {
+namespace avx512 {
+
+struct VecD {
+    using scalar = double;
+    using type = __m512d;
+    static constexpr size_t width = 8;
+
+    static type load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, type v) { _mm512_storeu_pd(p, v); }
+    static type set1(double x) { return _mm512_set1_pd(x); }
+    static type zero() { return _mm512_setzero_pd(); }
+    static type add(type a, type b) { return _mm512_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm512_div_pd(a, b); }
+    static type min(type a, type b) { return _mm512_min_pd(a, b); }
+    static type max(type a, type b) { return _mm512_max_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+    static type round(type a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static type select_lt(type a, type b, type x, type y) {
+        return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ), y, x);
+    }
+    static type pow2i(type n) { return _mm512_scalef_pd(set1(1), n); }
+    static double reduce_add(type v) { return _mm512_reduce_add_pd(v); }
+    static double reduce_max(type v) { return _mm512_reduce_max_pd(v); }
+};
+
+struct VecF {
+    using scalar = float;
+    using type = __m512;
+    static constexpr size_t width = 16;
+
+    static type load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, type v) { _mm512_storeu_ps(p, v); }
+    static type set1(float x) { return _mm512_set1_ps(x); }
+    static type zero() { return _mm512_setzero_ps(); }
+    static type add(type a, type b) { return _mm512_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm512_div_ps(a, b); }
+    static type min(type a, type b) { return _mm512_min_ps(a, b); }
+    static type max(type a, type b) { return _mm512_max_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+    static type round(type a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static type select_lt(type a, type b, type x, type y) {
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x);
+    }
+    static type pow2i(type n) { return _mm512_scalef_ps(set1(1), n); }
+    static float reduce_add(type v) { return _mm512_reduce_add_ps(v); }
+    static float reduce_max(type v) { return _mm512_reduce_max_ps(v); }
+};
+
+void bf16_to_float(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i wide = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+        _mm512_storeu_ps(dst + i, _mm512_castsi512_ps(_mm512_slli_epi32(wide, 16)));
+    }
+    for (; i < n; ++i) {
+        dst[i] = ::bf16_to_float(src[i]);
+    }
+}
+
+void fp16_to_float(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+    }
+    for (; i < n; ++i) {
+        dst[i] = ::fp16_to_float(src[i]);
+    }
+}
+
+} // namespace avx512
+} // namespace Kernels
+
+#include "kernel_templates.h"
+
+// The int8 kernel additionally needs VNNI (vpdpbusd), which not every
+// AVX-512F host has; it is only installed when the CPU reports it
+#pragma GCC push_options
+#pragma GCC target("avx512vnni")
+
+namespace Kernels {
+namespace avx512 {
+
+// R rows x one 16-column panel. vpdpbusd multiplies unsigned by signed bytes
+// and sums groups of four into int32 lanes, so a comes in shifted to unsigned
+// (a + 128) and 128 * sum(b) is taken off the result. b stays untouched, so
+// one load of it serves all R rows.
+template <int R>
+void gemm_int8_vnni_tile(const uint8_t* a, size_t lda, const int8_t* panel, const int32_t* b_sums,
+                         int32_t* c, size_t ldc, size_t n, size_t k) {
+    __m512i acc[R];
+#pragma GCC unroll 16
+    for (int r = 0; r < R; ++r) {
+        acc[r] = _mm512_setzero_si512();
+    }
+    for (size_t p = 0; p < k; p += 4) {
+        const __m512i vb = _mm512_load_si512(panel + p * 16);
+#pragma GCC unroll 16
+        for (int r = 0; r < R; ++r) {
+            int32_t quad;
+            std::memcpy(&quad, a + r * lda + p, sizeof(quad));
+            acc[r] = _mm512_dpbusd_epi32(acc[r], _mm512_set1_epi32(quad), vb);
+        }
+    }
+    const __mmask16 mask = n >= 16 ? __mmask16(0xffff) : __mmask16((1u << n) - 1);
+    const __m512i correction = _mm512_slli_epi32(_mm512_maskz_loadu_epi32(mask, b_sums), 7);
+#pragma GCC unroll 16
+    for (int r = 0; r < R; ++r) {
+        _mm512_mask_storeu_epi32(c + r * ldc, mask, _mm512_sub_epi32(acc[r], correction));
+    }
+}
+
+void gemm_int8_vnni(const int8_t* a, size_t lda, const int8_t* b, const int32_t* b_sums,
+                    int32_t* c, size_t ldc, size_t m, size_t n, size_t k) {
+    // Shift a once per call rather than once per panel
+    thread_local std::vector<uint8_t> shifted;
+    shifted.resize(m * k);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t p = 0; p < k; ++p) {
+            shifted[i * k + p] = static_cast<uint8_t>(a[i * lda + p] ^ 0x80);
+        }
+    }
+    const uint8_t* a_u8 = shifted.data();
+
+    for (size_t j = 0; j < n; j += 16) {
+        const int8_t* panel = b + j * k;
+        const size_t cols = std::min<size_t>(16, n - j);
+        size_t i = 0;
+        for (; i + 8 <= m; i += 8) {
+            gemm_int8_vnni_tile<8>(a_u8 + i * k, k, panel, b_sums + j, c + i * ldc + j, ldc, cols, k);
+        }
+        for (; i + 4 <= m; i += 4) {
+            gemm_int8_vnni_tile<4>(a_u8 + i * k, k, panel, b_sums + j, c + i * ldc + j, ldc, cols, k);
+        }
+        for (; i < m; ++i) {
+            gemm_int8_vnni_tile<1>(a_u8 + i * k, k, panel, b_sums + j, c + i * ldc + j, ldc, cols, k);
+        }
+    }
+}
+
+} // namespace avx512
+} // namespace Kernels
+
+#pragma GCC pop_options
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+namespace {
+
+bool cpu_has_vnni() {
+    return __builtin_cpu_supports("avx512vnni");
+}
+
+} // namespace
+
+namespace Kernels {
+
+const KernelSet& avx512_kernels() {
+    // 8 x 16 (double) / 8 x 32 (float) tile: 16 accumulators + 2 B vectors
+    // + 1 broadcast of 32 zmm registers
+    static const KernelSet set{
+        Isa::AVX512, "avx512",
+        detail::make_table<avx512::VecD, 8, 2, MathMode::Fast>(Isa::AVX512, "avx512"),
+        detail::make_table<avx512::VecF, 8, 2, MathMode::Fast>(Isa::AVX512, "avx512"),
+        detail::make_table<avx512::VecD, 8, 2, MathMode::Exact>(Isa::AVX512, "avx512"),
+        detail::make_table<avx512::VecF, 8, 2, MathMode::Exact>(Isa::AVX512, "avx512"),
+        // Without VNNI, the AVX2 kernel that every AVX-512 host supports
+        cpu_has_vnni() ? avx512::gemm_int8_vnni : avx2_kernels().gemm_int8,
+        avx512::bf16_to_float,
+        avx512::fp16_to_float,
+    };
+    return set;
+}
+
+} // namespace Kernels
+
+#else
+
+namespace Kernels {
+
+// Not an x86 target: the dispatcher never selects this set
+const KernelSet& avx512_kernels() {
+    return scalar_kernels();
+}
+
+} // namespace Kernels
+
+#endif
@@ -0,0 +1,78 @@
+#include "../../../include/matrix/kernels.h"
+#include "kernel_templates.h"
+#include "../../../include/matrix/half.h"
+
+// Portable fallback: a one-lane "vector", compiled for the baseline target
+namespace Kernels {
+namespace scalar {
+
+template <typename T>
+struct Vec {
+    using scalar = T;
+    using type = T;
+    static constexpr size_t width = 1;
+
+    static type load(const T* p) { return *p; }
+    static void store(T* p, type v) { *p = v; }
+    static type set1(T x) { return x; }
+    static type zero() { return T(0); }
+    static type add(type a, type b) { return a + b; }
+    static type sub(type a, type b) { return a - b; }
+    static type mul(type a, type b) { return a * b; }
+    static type div(type a, type b) { return a / b; }
+    static type min(type a, type b) { return a < b ? a : b; }
+    static type max(type a, type b) { return a > b ? a : b; }
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+    static type round(type a) { return std::nearbyint(a); }
+    static type select_lt(type a, type b, type x, type y) { return a < b ? x : y; }
+    static type pow2i(type n) { return std::ldexp(T(1), static_cast<int>(n)); }
+    static T reduce_add(type v) { return v; }
+    static T reduce_max(type v) { return v; }
+};
+
+void gemm_int8(const int8_t* a, size_t lda, const int8_t* b, const int32_t* /*b_sums*/,
+               int32_t* c, size_t ldc, size_t m, size_t n, size_t k) {
+    for (size_t j0 = 0; j0 < n; j0 += 16) {
+        const int8_t* panel = b + j0 * k;
+        const size_t cols = std::min<size_t>(16, n - j0);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                int32_t dot = 0;
+                for (size_t p = 0; p < k; ++p) {
+                    dot += int32_t(a[i * lda + p]) * int32_t(panel[p / 4 * 64 + j * 4 + p % 4]);
+                }
+                c[i * ldc + j0 + j] = dot;
+            }
+        }
+    }
+}
+
+void bf16_to_float(const uint16_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = ::bf16_to_float(src[i]);
+    }
+}
+
+void fp16_to_float(const uint16_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = ::fp16_to_float(src[i]);
+    }
+}
+
+} // namespace scalar
+
+const KernelSet& scalar_kernels() {
+    static const KernelSet set{
+        Isa::Scalar, "scalar",
+        detail::make_table<scalar::Vec<double>, 4, 8, MathMode::Fast>(Isa::Scalar, "scalar"),
+        detail::make_table<scalar::Vec<float>, 4, 8, MathMode::Fast>(Isa::Scalar, "scalar"),
+        detail::make_table<scalar::Vec<double>, 4, 8, MathMode::Exact>(Isa::Scalar, "scalar"),
+        detail::make_table<scalar::Vec<float>, 4, 8, MathMode::Exact>(Isa::Scalar, "scalar"),
+        scalar::gemm_int8,
+        scalar::bf16_to_float,
+        scalar::fp16_to_float,
+    };
+    return set;
+}
+
+} // namespace Kernels
@@ -3,18 +3,25 @@
 //
 
 #include "../../include/matrix/matrix.h"
+#include "../../include/matrix/kernels.h"
 #include <random>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 // Default constructor
-Matrix::Matrix() : rows(0), cols(0) {}
+template <typename T>
+BasicMatrix<T>::BasicMatrix() : rows(0), cols(0) {}
 
 // Parameterized constructor
-Matrix::Matrix(size_t rows, size_t cols, double value)
-    : rows(rows), cols(cols), data(rows, std::vector<double>(cols, value)) {}
+template <typename T>
+BasicMatrix<T>::BasicMatrix(size_t rows, size_t cols, T value)
+    : rows(rows), cols(cols), values(rows * cols, value) {}
 
 // Initializer list constructor
-Matrix::Matrix(const std::initializer_list<std::initializer_list<double>>& init_list) {
+template <typename T>
+BasicMatrix<T>::BasicMatrix(const std::initializer_list<std::initializer_list<T>>& init_list) {
     rows = init_list.size();
     if (rows == 0) {
         cols = 0;
@@ -22,45 +29,56 @@ Matrix::Matrix(const std::initializer_list<std::initializer_list<double>>& init_
     }
 
     cols = init_list.begin()->size();
-    data.resize(rows);
+    values.reserve(rows * cols);
 
-    size_t i = 0;
     for (const auto& row : init_list) {
         if (row.size() != cols) {
             throw std::invalid_argument("All rows must have the same number of columns");
         }
-        data[i].assign(row.begin(), row.end());
-        ++i;
+        values.insert(values.end(), row.begin(), row.end());
+    }
+}
+
+// View constructor
+template <typename T>
+BasicMatrix<T>::BasicMatrix(BasicConstMatrixView<T> view)
+    : rows(view.getRows()), cols(view.getCols()), values(view.getRows() * view.getCols()) {
+    for (size_t i = 0; i < rows; ++i) {
+        std::copy(view.row_ptr(i), view.row_ptr(i) + cols, values.data() + i * cols);
     }
 }
 
 // Copy constructor
-Matrix::Matrix(const Matrix& other)
-    : rows(other.rows), cols(other.cols), data(other.data) {}
+template <typename T>
+BasicMatrix<T>::BasicMatrix(const BasicMatrix& other)
+    : rows(other.rows), cols(other.cols), values(other.values) {}
 
 // Copy assignment
-Matrix& Matrix::operator=(const Matrix& other) {
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator=(const BasicMatrix& other) {
     if (this != &other) {
         rows = other.rows;
         cols = other.cols;
-        data = other.data;
+        values = other.values;
     }
     return *this;
 }
 
 // Move constructor
-Matrix::Matrix(Matrix&& other) noexcept
-    : rows(other.rows), cols(other.cols), data(std::move(other.data)) {
+template <typename T>
+BasicMatrix<T>::BasicMatrix(BasicMatrix&& other) noexcept
+    : rows(other.rows), cols(other.cols), values(std::move(other.values)) {
     other.rows = 0;
     other.cols = 0;
 }
 
 // Move assignment
-Matrix& Matrix::operator=(Matrix&& other) noexcept {
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator=(BasicMatrix&& other) noexcept {
     if (this != &other) {
         rows = other.rows;
         cols = other.cols;
-        data = std::move(other.data);
+        values = std::move(other.values);
         other.rows = 0;
         other.cols = 0;
     }
@@ -68,152 +86,127 @@ Matrix& Matrix::operator=(Matrix&& other) noexcept {
 }
 
 // Element access
-double& Matrix::operator()(size_t row, size_t col) {
+template <typename T>
+T& BasicMatrix<T>::operator()(size_t row, size_t col) {
     if (row >= rows || col >= cols) {
         throw std::out_of_range("Matrix indices out of range");
     }
-    return data[row][col];
+    return values[row * cols + col];
 }
 
-const double& Matrix::operator()(size_t row, size_t col) const {
+template <typename T>
+const T& BasicMatrix<T>::operator()(size_t row, size_t col) const {
     if (row >= rows || col >= cols) {
         throw std::out_of_range("Matrix indices out of range");
     }
-    return data[row][col];
+    return values[row * cols + col];
 }
 
-// Utility functions
-void Matrix::fill(double value) {
-    for (auto& row : data) {
-        std::fill(row.begin(), row.end(), value);
+// Views
+template <typename T>
+BasicMatrixView<T> BasicMatrix<T>::block(size_t row, size_t col, size_t num_rows, size_t num_cols) {
+    if (row + num_rows > rows || col + num_cols > cols) {
+        throw std::out_of_range("Matrix block out of range");
+    }
+    return BasicMatrixView<T>(values.data() + row * cols + col, num_rows, num_cols, cols);
+}
+
+template <typename T>
+BasicConstMatrixView<T> BasicMatrix<T>::block(size_t row, size_t col, size_t num_rows, size_t num_cols) const {
+    if (row + num_rows > rows || col + num_cols > cols) {
+        throw std::out_of_range("Matrix block out of range");
     }
+    return BasicConstMatrixView<T>(values.data() + row * cols + col, num_rows, num_cols, cols);
+}
+
+// Utility functions
+template <typename T>
+void BasicMatrix<T>::fill(T value) {
+    std::fill(values.begin(), values.end(), value);
 }
 
-void Matrix::resize(size_t new_rows, size_t new_cols, double value) {
+template <typename T>
+void BasicMatrix<T>::resize(size_t new_rows, size_t new_cols, T value) {
     rows = new_rows;
     cols = new_cols;
-    data.assign(rows, std::vector<double>(cols, value));
+    values.assign(rows * cols, value);
 }
 
-void Matrix::print() const {
-    for (const auto& row : data) {
-        for (const auto& elem : row) {
-            std::cout << std::setw(8) << std::fixed << std::setprecision(3) << elem << " ";
+template <typename T>
+void BasicMatrix<T>::print() const {
+    for (size_t i = 0; i < rows; ++i) {
+        const T* row = row_ptr(i);
+        for (size_t j = 0; j < cols; ++j) {
+            std::cout << std::setw(8) << std::fixed << std::setprecision(3) << row[j] << " ";
         }
         std::cout << std::endl;
     }
 }
 
 // Static factory methods
-Matrix Matrix::zeros(size_t rows, size_t cols) {
-    return Matrix(rows, cols, 0.0);
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::zeros(size_t rows, size_t cols) {
+    return BasicMatrix(rows, cols, T(0));
 }
 
-Matrix Matrix::ones(size_t rows, size_t cols) {
-    return Matrix(rows, cols, 1.0);
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::ones(size_t rows, size_t cols) {
+    return BasicMatrix(rows, cols, T(1));
 }
 
-Matrix Matrix::identity(size_t size) {
-    Matrix result(size, size, 0.0);
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::identity(size_t size) {
+    BasicMatrix result(size, size, T(0));
     for (size_t i = 0; i < size; ++i) {
-        result(i, i) = 1.0;
+        result.values[i * size + i] = T(1);
     }
     return result;
 }
 
-Matrix Matrix::random(size_t rows, size_t cols, double min, double max) {
-    Matrix result(rows, cols);
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::random(size_t rows, size_t cols, T min, T max) {
+    BasicMatrix result(rows, cols);
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dis(min, max);
-
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = dis(gen);
-        }
-    }
-    return result;
-}
-
-// Basic operators
-Matrix Matrix::operator+(const Matrix& other) const {
-    if (rows != other.rows || cols != other.cols) {
-        throw std::invalid_argument("Matrices must have the same dimensions for addition");
-    }
-
-    Matrix result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = data[i][j] + other.data[i][j];
-        }
-    }
-    return result;
-}
+    std::uniform_real_distribution<T> dis(min, max);
 
-Matrix Matrix::operator-(const Matrix& other) const {
-    if (rows != other.rows || cols != other.cols) {
-        throw std::invalid_argument("Matrices must have the same dimensions for subtraction");
-    }
-
-    Matrix result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = data[i][j] - other.data[i][j];
-        }
+    for (T& value : result.values) {
+        value = dis(gen);
     }
     return result;
 }
 
-Matrix Matrix::operator*(double scalar) const {
-    Matrix result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = data[i][j] * scalar;
-        }
-    }
-    return result;
-}
-
-Matrix Matrix::operator/(double scalar) const {
-    if (scalar == 0.0) {
-        throw std::invalid_argument("Division by zero");
-    }
-    return (*this) * (1.0 / scalar);
-}
-
 // Comparison operators
-bool Matrix::operator==(const Matrix& other) const {
+template <typename T>
+bool BasicMatrix<T>::operator==(const BasicMatrix& other) const {
     if (rows != other.rows || cols != other.cols) {
         return false;
     }
 
-    const double epsilon = 1e-9;
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            if (std::abs(data[i][j] - other.data[i][j]) > epsilon) {
-                return false;
-            }
+    const T epsilon = std::is_same<T, float>::value ? T(1e-5) : T(1e-9);
+    for (size_t i = 0, n = values.size(); i < n; ++i) {
+        if (std::abs(values[i] - other.values[i]) > epsilon) {
+            return false;
         }
     }
     return true;
 }
 
-bool Matrix::operator!=(const Matrix& other) const {
+template <typename T>
+bool BasicMatrix<T>::operator!=(const BasicMatrix& other) const {
     return !(*this == other);
 }
 
-// Friend functions
-Matrix operator*(double scalar, const Matrix& matrix) {
-    return matrix * scalar;
-}
-
-std::ostream& operator<<(std::ostream& os, const Matrix& matrix) {
-    for (size_t i = 0; i < matrix.rows; ++i) {
-        for (size_t j = 0; j < matrix.cols; ++j) {
-            os << std::setw(8) << std::fixed << std::setprecision(3) << matrix.data[i][j];
-            if (j < matrix.cols - 1) os << " ";
+template <typename T>
+void BasicMatrix<T>::write(std::ostream& os) const {
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            os << std::setw(8) << std::fixed << std::setprecision(3) << values[i * cols + j];
+            if (j < cols - 1) os << " ";
         }
-        if (i < matrix.rows - 1) os << "\n";
+        if (i < rows - 1) os << "\n";
     }
-    return os;
-}
\ No newline at end of file
+}
+
+template class BasicMatrix<double>;
+template class BasicMatrix<float>;
@@ -3,191 +3,322 @@
 //
 
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/gemm.h"
+#include "../../include/matrix/kernels.h"
+#include "../../include/utils/thread_pool.h"
 #include <cmath>
 #include <algorithm>
 
 namespace MatrixOps {
 
-Matrix matmul(const Matrix& a, const Matrix& b) {
+namespace {
+
+template <typename A, typename B>
+void check_same_shape(const A& a, const B& b, const char* message) {
+    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
+        throw std::invalid_argument(message);
+    }
+}
+
+template <typename T>
+BasicMatrix<T> matmul_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
     if (a.getCols() != b.getRows()) {
         throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
 
-    size_t rows = a.getRows();
-    size_t cols = b.getCols();
-    size_t inner = a.getCols();
+    BasicMatrix<T> result(a.getRows(), b.getCols());
+    Gemm::gemm(a, b, result.view());
+    return result;
+}
 
-    Matrix result(rows, cols, 0.0);
+template <typename T>
+void matmul_into_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b, BasicMatrixView<T> out) {
+    Gemm::gemm(a, b, out);
+}
 
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            for (size_t k = 0; k < inner; ++k) {
-                result(i, j) += a(i, k) * b(k, j);
-            }
-        }
+// a * b^T and a^T * b without materializing the transpose
+template <typename T>
+BasicMatrix<T> matmul_nt_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    if (a.getCols() != b.getCols()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
 
+    BasicMatrix<T> result(a.getRows(), b.getRows());
+    Gemm::gemm_nt(a, b, result.view());
     return result;
 }
 
-Matrix add(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have the same dimensions for addition");
+template <typename T>
+BasicMatrix<T> matmul_tn_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    if (a.getRows() != b.getRows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            result(i, j) = a(i, j) + b(i, j);
-        }
-    }
+    BasicMatrix<T> result(a.getCols(), b.getCols());
+    Gemm::gemm_tn(a, b, result.view());
     return result;
 }
 
-Matrix subtract(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have the same dimensions for subtraction");
+template <typename T>
+BasicMatrix<T> linear_impl(BasicConstMatrixView<T> input, BasicConstMatrixView<T> weight,
+                           BasicConstMatrixView<T> bias, Activation activation) {
+    if (input.getCols() != weight.getRows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            result(i, j) = a(i, j) - b(i, j);
+    BasicMatrix<T> result(input.getRows(), weight.getCols());
+    Gemm::linear(input, weight, bias, result.view(), activation);
+    return result;
+}
+
+template <typename T>
+BasicMatrix<T> matmul_reference_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    BasicMatrix<T> result(a.getRows(), b.getCols());
+    Gemm::gemm_reference(a, b, result.view());
+    return result;
+}
+
+template <typename T>
+void add_into_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b, BasicMatrixView<T> out) {
+    check_same_shape(a, b, "Matrices must have the same dimensions for addition");
+    check_same_shape(a, out, "Output dimensions must match for addition");
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    if (a.isContiguous() && b.isContiguous() && out.isContiguous()) {
+        kernels.add(a.data(), b.data(), out.data(), a.size());
+    } else {
+        for (size_t i = 0; i < a.getRows(); ++i) {
+            kernels.add(a.row_ptr(i), b.row_ptr(i), out.row_ptr(i), a.getCols());
         }
     }
+}
+
+template <typename T>
+BasicMatrix<T> add_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    check_same_shape(a, b, "Matrices must have the same dimensions for addition");
+
+    BasicMatrix<T> result(a.getRows(), a.getCols());
+    add_into_impl(a, b, result.view());
     return result;
 }
 
-Matrix elementWiseMultiply(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have same dimensions for element-wise multiplication");
-    }
+template <typename T>
+void subtract_into_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b, BasicMatrixView<T> out) {
+    check_same_shape(a, b, "Matrices must have the same dimensions for subtraction");
+    check_same_shape(a, out, "Output dimensions must match for subtraction");
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            result(i, j) = a(i, j) * b(i, j);
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    if (a.isContiguous() && b.isContiguous() && out.isContiguous()) {
+        kernels.sub(a.data(), b.data(), out.data(), a.size());
+    } else {
+        for (size_t i = 0; i < a.getRows(); ++i) {
+            kernels.sub(a.row_ptr(i), b.row_ptr(i), out.row_ptr(i), a.getCols());
         }
     }
+}
+
+template <typename T>
+BasicMatrix<T> subtract_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    BasicMatrix<T> result(a.getRows(), a.getCols());
+    subtract_into_impl(a, b, result.view());
     return result;
 }
 
-Matrix elementWiseDivide(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have same dimensions for element-wise division");
+template <typename T>
+BasicMatrix<T> elementWiseMultiply_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    check_same_shape(a, b, "Matrices must have same dimensions for element-wise multiplication");
+
+    BasicMatrix<T> result(a.getRows(), a.getCols());
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    if (a.isContiguous() && b.isContiguous()) {
+        kernels.mul(a.data(), b.data(), result.data(), result.size());
+    } else {
+        for (size_t i = 0; i < a.getRows(); ++i) {
+            kernels.mul(a.row_ptr(i), b.row_ptr(i), result.row_ptr(i), a.getCols());
+        }
     }
+    return result;
+}
 
-    Matrix result(a.getRows(), a.getCols());
+template <typename T>
+BasicMatrix<T> elementWiseDivide_impl(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    check_same_shape(a, b, "Matrices must have same dimensions for element-wise division");
+
+    BasicMatrix<T> result(a.getRows(), a.getCols());
     for (size_t i = 0; i < a.getRows(); ++i) {
+        const T* pa = a.row_ptr(i);
+        const T* pb = b.row_ptr(i);
+        T* out = result.row_ptr(i);
         for (size_t j = 0; j < a.getCols(); ++j) {
-            if (b(i, j) == 0.0) {
+            if (pb[j] == T(0)) {
                 throw std::invalid_argument("Division by zero in element-wise division");
             }
-            result(i, j) = a(i, j) / b(i, j);
+            out[j] = pa[j] / pb[j];
         }
     }
     return result;
 }
 
-Matrix transpose(const Matrix& matrix) {
-    Matrix result(matrix.getCols(), matrix.getRows());
-    for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result(j, i) = matrix(i, j);
+template <typename T>
+void transpose_into_impl(BasicConstMatrixView<T> matrix, BasicMatrixView<T> out) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    if (out.getRows() != cols || out.getCols() != rows) {
+        throw std::invalid_argument("Output dimensions must match the transposed matrix");
+    }
+
+    // Transpose in square tiles so both source and destination stay cache resident
+    const size_t tile = 32;
+    for (size_t i0 = 0; i0 < rows; i0 += tile) {
+        const size_t i_end = std::min(i0 + tile, rows);
+        for (size_t j0 = 0; j0 < cols; j0 += tile) {
+            const size_t j_end = std::min(j0 + tile, cols);
+            for (size_t i = i0; i < i_end; ++i) {
+                const T* src = matrix.row_ptr(i);
+                for (size_t j = j0; j < j_end; ++j) {
+                    out.row_ptr(j)[i] = src[j];
+                }
+            }
         }
     }
+}
+
+template <typename T>
+BasicMatrix<T> transpose_impl(BasicConstMatrixView<T> matrix) {
+    BasicMatrix<T> result(matrix.getCols(), matrix.getRows());
+    transpose_into_impl(matrix, result.view());
     return result;
 }
 
-Matrix addBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+void copy_impl(BasicConstMatrixView<T> src, BasicMatrixView<T> dst) {
+    check_same_shape(src, dst, "Matrices must have the same dimensions for copy");
+
+    for (size_t i = 0; i < src.getRows(); ++i) {
+        std::copy(src.row_ptr(i), src.row_ptr(i) + src.getCols(), dst.row_ptr(i));
+    }
+}
+
+template <typename T>
+void scale_into_impl(BasicConstMatrixView<T> matrix, T scalar, BasicMatrixView<T> out) {
+    check_same_shape(matrix, out, "Output dimensions must match for scaling");
 
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    for (size_t i = 0; i < matrix.getRows(); ++i) {
+        kernels.scale(matrix.row_ptr(i), scalar, out.row_ptr(i), matrix.getCols());
+    }
+}
+
+template <typename T>
+void addBroadcast_into_impl(BasicConstMatrixView<T> matrix, BasicConstMatrixView<T> vector,
+                            BasicMatrixView<T> out, bool row_vector) {
+    check_same_shape(matrix, out, "Output dimensions must match for broadcasting");
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
     if (row_vector) {
         // Broadcasting row vector across all rows
         if (vector.getCols() != matrix.getCols() || vector.getRows() != 1) {
             throw std::invalid_argument("Vector dimensions incompatible for row broadcasting");
         }
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) + vector(0, j);
+        ThreadPool::global().parallel_for(matrix.getRows(), matrix.getCols(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                kernels.add(matrix.row_ptr(i), vector.data(), out.row_ptr(i), matrix.getCols());
             }
-        }
+        });
     } else {
         // Broadcasting column vector across all columns
         if (vector.getRows() != matrix.getRows() || vector.getCols() != 1) {
             throw std::invalid_argument("Vector dimensions incompatible for column broadcasting");
         }
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) + vector(i, 0);
+        ThreadPool::global().parallel_for(matrix.getRows(), matrix.getCols(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                kernels.add_scalar(matrix.row_ptr(i), vector(i, 0), out.row_ptr(i), matrix.getCols());
             }
-        }
+        });
     }
+}
 
+template <typename T>
+BasicMatrix<T> addBroadcast_impl(BasicConstMatrixView<T> matrix, BasicConstMatrixView<T> vector, bool row_vector) {
+    BasicMatrix<T> result(matrix.getRows(), matrix.getCols());
+    addBroadcast_into_impl(matrix, vector, result.view(), row_vector);
     return result;
 }
 
-Matrix multiplyBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+void multiplyBroadcast_into_impl(BasicConstMatrixView<T> matrix, BasicConstMatrixView<T> vector,
+                                 BasicMatrixView<T> out, bool row_vector) {
+    check_same_shape(matrix, out, "Output dimensions must match for broadcasting");
 
     if (row_vector) {
         if (vector.getCols() != matrix.getCols() || vector.getRows() != 1) {
             throw std::invalid_argument("Vector dimensions incompatible for row broadcasting");
         }
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) * vector(0, j);
+        const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+        ThreadPool::global().parallel_for(matrix.getRows(), matrix.getCols(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                kernels.mul(matrix.row_ptr(i), vector.data(), out.row_ptr(i), matrix.getCols());
             }
-        }
+        });
     } else {
         if (vector.getRows() != matrix.getRows() || vector.getCols() != 1) {
             throw std::invalid_argument("Vector dimensions incompatible for column broadcasting");
         }
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) * vector(i, 0);
+        const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+        ThreadPool::global().parallel_for(matrix.getRows(), matrix.getCols(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                kernels.scale(matrix.row_ptr(i), vector(i, 0), out.row_ptr(i), matrix.getCols());
             }
-        }
+        });
     }
+}
 
+template <typename T>
+BasicMatrix<T> multiplyBroadcast_impl(BasicConstMatrixView<T> matrix, BasicConstMatrixView<T> vector, bool row_vector) {
+    BasicMatrix<T> result(matrix.getRows(), matrix.getCols());
+    multiplyBroadcast_into_impl(matrix, vector, result.view(), row_vector);
     return result;
 }
 
-double sum(const Matrix& matrix) {
-    double total = 0.0;
+template <typename T>
+T sum_impl(BasicConstMatrixView<T> matrix) {
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+    if (matrix.isContiguous()) {
+        return kernels.sum(matrix.data(), matrix.size());
+    }
+    T total = T(0);
     for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            total += matrix(i, j);
-        }
+        total += kernels.sum(matrix.row_ptr(i), matrix.getCols());
     }
     return total;
 }
 
-double mean(const Matrix& matrix) {
-    return sum(matrix) / (matrix.getRows() * matrix.getCols());
+template <typename T>
+T mean_impl(BasicConstMatrixView<T> matrix) {
+    return sum_impl(matrix) / (matrix.getRows() * matrix.getCols());
 }
 
-Matrix sumAxis(const Matrix& matrix, int axis) {
+template <typename T>
+BasicMatrix<T> sumAxis_impl(BasicConstMatrixView<T> matrix, int axis) {
     if (axis == 0) {
         // Sum across rows (result is row vector)
-        Matrix result(1, matrix.getCols(), 0.0);
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            for (size_t i = 0; i < matrix.getRows(); ++i) {
-                result(0, j) += matrix(i, j);
-            }
+        BasicMatrix<T> result(1, matrix.getCols());
+        const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+        for (size_t i = 0; i < matrix.getRows(); ++i) {
+            kernels.add(result.data(), matrix.row_ptr(i), result.data(), matrix.getCols());
         }
         return result;
     } else if (axis == 1) {
         // Sum across columns (result is column vector)
-        Matrix result(matrix.getRows(), 1, 0.0);
+        BasicMatrix<T> result(matrix.getRows(), 1);
+        const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
+        T* out = result.data();
         for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, 0) += matrix(i, j);
-            }
+            out[i] = kernels.sum(matrix.row_ptr(i), matrix.getCols());
         }
         return result;
     } else {
@@ -195,53 +326,227 @@ Matrix sumAxis(const Matrix& matrix, int axis) {
     }
 }
 
-Matrix meanAxis(const Matrix& matrix, int axis) {
-    Matrix result = sumAxis(matrix, axis);
+template <typename T>
+BasicMatrix<T> meanAxis_impl(BasicConstMatrixView<T> matrix, int axis) {
+    BasicMatrix<T> result = sumAxis_impl(matrix, axis);
     if (axis == 0) {
-        result = result / static_cast<double>(matrix.getRows());
+        result = result / static_cast<T>(matrix.getRows());
     } else {
-        result = result / static_cast<double>(matrix.getCols());
+        result = result / static_cast<T>(matrix.getCols());
     }
     return result;
 }
 
-Matrix power(const Matrix& matrix, double exponent) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+BasicMatrix<T> power_impl(BasicConstMatrixView<T> matrix, double exponent) {
+    BasicMatrix<T> result(matrix.getRows(), matrix.getCols());
     for (size_t i = 0; i < matrix.getRows(); ++i) {
+        const T* src = matrix.row_ptr(i);
+        T* out = result.row_ptr(i);
         for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result(i, j) = std::pow(matrix(i, j), exponent);
+            out[j] = static_cast<T>(std::pow(src[j], exponent));
         }
     }
     return result;
 }
 
-Matrix sqrt(const Matrix& matrix) {
-    return power(matrix, 0.5);
+template <typename T>
+BasicMatrix<T> sqrt_impl(BasicConstMatrixView<T> matrix) {
+    return power_impl(matrix, 0.5);
 }
 
-Matrix exp(const Matrix& matrix) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+void exp_into_impl(BasicConstMatrixView<T> matrix, BasicMatrixView<T> out) {
+    check_same_shape(matrix, out, "Output dimensions must match for exp");
+
+    const Kernels::KernelTable<T>& kernels = Kernels::active<T>();
     for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result(i, j) = std::exp(matrix(i, j));
-        }
+        kernels.exp(matrix.row_ptr(i), out.row_ptr(i), matrix.getCols());
     }
+}
+
+template <typename T>
+BasicMatrix<T> exp_impl(BasicConstMatrixView<T> matrix) {
+    BasicMatrix<T> result(matrix.getRows(), matrix.getCols());
+    exp_into_impl(matrix, result.view());
     return result;
 }
 
-Matrix log(const Matrix& matrix) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+BasicMatrix<T> log_impl(BasicConstMatrixView<T> matrix) {
+    BasicMatrix<T> result(matrix.getRows(), matrix.getCols());
     for (size_t i = 0; i < matrix.getRows(); ++i) {
+        const T* src = matrix.row_ptr(i);
+        T* out = result.row_ptr(i);
         for (size_t j = 0; j < matrix.getCols(); ++j) {
-            if (matrix(i, j) <= 0.0) {
+            if (src[j] <= T(0)) {
                 throw std::invalid_argument("Logarithm of non-positive number");
             }
-            result(i, j) = std::log(matrix(i, j));
+            out[j] = std::log(src[j]);
         }
     }
     return result;
 }
 
+} // namespace
+
+// Public overloads: one per precision, so a Matrix or MatrixF converts to its view
+
+Matrix matmul(ConstMatrixView a, ConstMatrixView b) { return matmul_impl(a, b); }
+MatrixF matmul(ConstMatrixViewF a, ConstMatrixViewF b) { return matmul_impl(a, b); }
+void matmul_into(ConstMatrixView a, ConstMatrixView b, MatrixView out) { matmul_into_impl(a, b, out); }
+void matmul_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out) { matmul_into_impl(a, b, out); }
+Matrix matmul_nt(ConstMatrixView a, ConstMatrixView b) { return matmul_nt_impl(a, b); }
+MatrixF matmul_nt(ConstMatrixViewF a, ConstMatrixViewF b) { return matmul_nt_impl(a, b); }
+void matmul_nt_into(ConstMatrixView a, ConstMatrixView b, MatrixView out) { Gemm::gemm_nt(a, b, out); }
+void matmul_nt_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out) { Gemm::gemm_nt(a, b, out); }
+Matrix matmul_tn(ConstMatrixView a, ConstMatrixView b) { return matmul_tn_impl(a, b); }
+MatrixF matmul_tn(ConstMatrixViewF a, ConstMatrixViewF b) { return matmul_tn_impl(a, b); }
+void matmul_tn_into(ConstMatrixView a, ConstMatrixView b, MatrixView out) { Gemm::gemm_tn(a, b, out); }
+void matmul_tn_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out) { Gemm::gemm_tn(a, b, out); }
+
+void matmul_batched_into(size_t batch, ConstMatrixView a, size_t stride_a, ConstMatrixView b, size_t stride_b,
+                         MatrixView out, size_t stride_out, bool trans_a, bool trans_b) {
+    Gemm::gemm_batched(batch, a, stride_a, trans_a, b, stride_b, trans_b, out, stride_out);
+}
+void matmul_batched_into(size_t batch, ConstMatrixViewF a, size_t stride_a, ConstMatrixViewF b, size_t stride_b,
+                         MatrixViewF out, size_t stride_out, bool trans_a, bool trans_b) {
+    Gemm::gemm_batched(batch, a, stride_a, trans_a, b, stride_b, trans_b, out, stride_out);
+}
+
+Matrix linear(ConstMatrixView input, ConstMatrixView weight, ConstMatrixView bias, Activation activation) {
+    return linear_impl(input, weight, bias, activation);
+}
+MatrixF linear(ConstMatrixViewF input, ConstMatrixViewF weight, ConstMatrixViewF bias, Activation activation) {
+    return linear_impl(input, weight, bias, activation);
+}
+void linear_into(ConstMatrixView input, ConstMatrixView weight, ConstMatrixView bias, MatrixView out,
+                 Activation activation) {
+    Gemm::linear(input, weight, bias, out, activation);
+}
+void linear_into(ConstMatrixViewF input, ConstMatrixViewF weight, ConstMatrixViewF bias, MatrixViewF out,
+                 Activation activation) {
+    Gemm::linear(input, weight, bias, out, activation);
+}
+void linear_nt_into(ConstMatrixView input, ConstMatrixView weight, ConstMatrixView bias, MatrixView out,
+                    Activation activation) {
+    Gemm::linear(input, weight, bias, out, activation, true);
+}
+void linear_nt_into(ConstMatrixViewF input, ConstMatrixViewF weight, ConstMatrixViewF bias, MatrixViewF out,
+                    Activation activation) {
+    Gemm::linear(input, weight, bias, out, activation, true);
+}
+
+void matmul_into(ConstMatrixView a, const PackedWeight& b, MatrixView out) { Gemm::linear(a, b, {}, out); }
+void matmul_into(ConstMatrixViewF a, const PackedWeightF& b, MatrixViewF out) { Gemm::linear(a, b, {}, out); }
+void linear_into(ConstMatrixView input, const PackedWeight& weight, ConstMatrixView bias, MatrixView out,
+                 Activation activation, size_t weight_col0) {
+    Gemm::linear(input, weight, bias, out, activation, weight_col0);
+}
+void linear_into(ConstMatrixViewF input, const PackedWeightF& weight, ConstMatrixViewF bias, MatrixViewF out,
+                 Activation activation, size_t weight_col0) {
+    Gemm::linear(input, weight, bias, out, activation, weight_col0);
+}
+
+void linear_int8_into(ConstMatrixView input, float input_scale, const QuantizedWeight& weight,
+                      ConstMatrixView bias, MatrixView out, Activation activation, size_t weight_col0) {
+    Gemm::linear_int8(input, input_scale, weight, bias, out, activation, weight_col0);
+}
+void linear_int8_into(ConstMatrixViewF input, float input_scale, const QuantizedWeight& weight,
+                      ConstMatrixViewF bias, MatrixViewF out, Activation activation, size_t weight_col0) {
+    Gemm::linear_int8(input, input_scale, weight, bias, out, activation, weight_col0);
+}
+
+Matrix matmul_reference(ConstMatrixView a, ConstMatrixView b) { return matmul_reference_impl(a, b); }
+MatrixF matmul_reference(ConstMatrixViewF a, ConstMatrixViewF b) { return matmul_reference_impl(a, b); }
+
+Matrix add(ConstMatrixView a, ConstMatrixView b) { return add_impl(a, b); }
+MatrixF add(ConstMatrixViewF a, ConstMatrixViewF b) { return add_impl(a, b); }
+void add_into(ConstMatrixView a, ConstMatrixView b, MatrixView out) { add_into_impl(a, b, out); }
+void add_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out) { add_into_impl(a, b, out); }
+void add_inplace(MatrixView a, ConstMatrixView b) { add_into_impl<double>(a, b, a); }
+void add_inplace(MatrixViewF a, ConstMatrixViewF b) { add_into_impl<float>(a, b, a); }
+Matrix subtract(ConstMatrixView a, ConstMatrixView b) { return subtract_impl(a, b); }
+MatrixF subtract(ConstMatrixViewF a, ConstMatrixViewF b) { return subtract_impl(a, b); }
+void subtract_into(ConstMatrixView a, ConstMatrixView b, MatrixView out) { subtract_into_impl(a, b, out); }
+void subtract_into(ConstMatrixViewF a, ConstMatrixViewF b, MatrixViewF out) { subtract_into_impl(a, b, out); }
+void subtract_inplace(MatrixView a, ConstMatrixView b) { subtract_into_impl<double>(a, b, a); }
+void subtract_inplace(MatrixViewF a, ConstMatrixViewF b) { subtract_into_impl<float>(a, b, a); }
+Matrix elementWiseMultiply(ConstMatrixView a, ConstMatrixView b) { return elementWiseMultiply_impl(a, b); }
+MatrixF elementWiseMultiply(ConstMatrixViewF a, ConstMatrixViewF b) { return elementWiseMultiply_impl(a, b); }
+Matrix elementWiseDivide(ConstMatrixView a, ConstMatrixView b) { return elementWiseDivide_impl(a, b); }
+MatrixF elementWiseDivide(ConstMatrixViewF a, ConstMatrixViewF b) { return elementWiseDivide_impl(a, b); }
+
+Matrix transpose(ConstMatrixView matrix) { return transpose_impl(matrix); }
+MatrixF transpose(ConstMatrixViewF matrix) { return transpose_impl(matrix); }
+void transpose_into(ConstMatrixView matrix, MatrixView out) { transpose_into_impl(matrix, out); }
+void transpose_into(ConstMatrixViewF matrix, MatrixViewF out) { transpose_into_impl(matrix, out); }
+void copy(ConstMatrixView src, MatrixView dst) { copy_impl(src, dst); }
+void copy(ConstMatrixViewF src, MatrixViewF dst) { copy_impl(src, dst); }
+void scale_into(ConstMatrixView matrix, double scalar, MatrixView out) { scale_into_impl(matrix, scalar, out); }
+void scale_into(ConstMatrixViewF matrix, float scalar, MatrixViewF out) { scale_into_impl(matrix, scalar, out); }
+void scale_inplace(MatrixView matrix, double scalar) { scale_into_impl<double>(matrix, scalar, matrix); }
+void scale_inplace(MatrixViewF matrix, float scalar) { scale_into_impl<float>(matrix, scalar, matrix); }
+
+Matrix addBroadcast(ConstMatrixView matrix, ConstMatrixView vector, bool row_vector) {
+    return addBroadcast_impl(matrix, vector, row_vector);
+}
+MatrixF addBroadcast(ConstMatrixViewF matrix, ConstMatrixViewF vector, bool row_vector) {
+    return addBroadcast_impl(matrix, vector, row_vector);
+}
+void addBroadcast_into(ConstMatrixView matrix, ConstMatrixView vector, MatrixView out, bool row_vector) {
+    addBroadcast_into_impl(matrix, vector, out, row_vector);
+}
+void addBroadcast_into(ConstMatrixViewF matrix, ConstMatrixViewF vector, MatrixViewF out, bool row_vector) {
+    addBroadcast_into_impl(matrix, vector, out, row_vector);
+}
+void addBroadcast_inplace(MatrixView matrix, ConstMatrixView vector, bool row_vector) {
+    addBroadcast_into_impl<double>(matrix, vector, matrix, row_vector);
+}
+void addBroadcast_inplace(MatrixViewF matrix, ConstMatrixViewF vector, bool row_vector) {
+    addBroadcast_into_impl<float>(matrix, vector, matrix, row_vector);
+}
+Matrix multiplyBroadcast(ConstMatrixView matrix, ConstMatrixView vector, bool row_vector) {
+    return multiplyBroadcast_impl(matrix, vector, row_vector);
+}
+MatrixF multiplyBroadcast(ConstMatrixViewF matrix, ConstMatrixViewF vector, bool row_vector) {
+    return multiplyBroadcast_impl(matrix, vector, row_vector);
+}
+void multiplyBroadcast_into(ConstMatrixView matrix, ConstMatrixView vector, MatrixView out, bool row_vector) {
+    multiplyBroadcast_into_impl(matrix, vector, out, row_vector);
+}
+void multiplyBroadcast_into(ConstMatrixViewF matrix, ConstMatrixViewF vector, MatrixViewF out, bool row_vector) {
+    multiplyBroadcast_into_impl(matrix, vector, out, row_vector);
+}
+void multiplyBroadcast_inplace(MatrixView matrix, ConstMatrixView vector, bool row_vector) {
+    multiplyBroadcast_into_impl<double>(matrix, vector, matrix, row_vector);
+}
+void multiplyBroadcast_inplace(MatrixViewF matrix, ConstMatrixViewF vector, bool row_vector) {
+    multiplyBroadcast_into_impl<float>(matrix, vector, matrix, row_vector);
+}
+
+double sum(ConstMatrixView matrix) { return sum_impl(matrix); }
+float sum(ConstMatrixViewF matrix) { return sum_impl(matrix); }
+double mean(ConstMatrixView matrix) { return mean_impl(matrix); }
+float mean(ConstMatrixViewF matrix) { return mean_impl(matrix); }
+Matrix sumAxis(ConstMatrixView matrix, int axis) { return sumAxis_impl(matrix, axis); }
+MatrixF sumAxis(ConstMatrixViewF matrix, int axis) { return sumAxis_impl(matrix, axis); }
+Matrix meanAxis(ConstMatrixView matrix, int axis) { return meanAxis_impl(matrix, axis); }
+MatrixF meanAxis(ConstMatrixViewF matrix, int axis) { return meanAxis_impl(matrix, axis); }
+
+Matrix power(ConstMatrixView matrix, double exponent) { return power_impl(matrix, exponent); }
+MatrixF power(ConstMatrixViewF matrix, double exponent) { return power_impl(matrix, exponent); }
+Matrix sqrt(ConstMatrixView matrix) { return sqrt_impl(matrix); }
+MatrixF sqrt(ConstMatrixViewF matrix) { return sqrt_impl(matrix); }
+Matrix exp(ConstMatrixView matrix) { return exp_impl(matrix); }
+MatrixF exp(ConstMatrixViewF matrix) { return exp_impl(matrix); }
+void exp_into(ConstMatrixView matrix, MatrixView out) { exp_into_impl(matrix, out); }
+void exp_into(ConstMatrixViewF matrix, MatrixViewF out) { exp_into_impl(matrix, out); }
+void exp_inplace(MatrixView matrix) { exp_into_impl<double>(matrix, matrix); }
+void exp_inplace(MatrixViewF matrix) { exp_into_impl<float>(matrix, matrix); }
+Matrix log(ConstMatrixView matrix) { return log_impl(matrix); }
+MatrixF log(ConstMatrixViewF matrix) { return log_impl(matrix); }
+
 double trace(const Matrix& matrix) {
     if (matrix.getRows() != matrix.getCols()) {
         throw std::invalid_argument("Matrix must be square to calculate trace");
@@ -0,0 +1,116 @@
+#include "../../include/matrix/packed_weight.h"
+#include "../../include/matrix/gemm.h"
+#include "../../include/matrix/kernels.h"
+#include "../../include/matrix/half.h"
+#include "gemm_packing.h"
+#include <algorithm>
+
+namespace {
+
+size_t round_up(size_t n, size_t multiple) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+void widen(const uint16_t* src, float* dst, size_t n, WeightStorage storage) {
+    const Kernels::KernelSet& kernels = Kernels::active_set();
+    (storage == WeightStorage::BF16 ? kernels.bf16_to_float : kernels.fp16_to_float)(src, dst, n);
+}
+
+void widen(const uint16_t* src, double* dst, size_t n, WeightStorage storage) {
+    // Through float in cache-sized chunks
+    float chunk[256];
+    for (size_t i = 0; i < n; i += 256) {
+        const size_t count = std::min<size_t>(256, n - i);
+        widen(src + i, chunk, count, storage);
+        std::copy(chunk, chunk + count, dst + i);
+    }
+}
+
+} // namespace
+
+const char* weight_storage_name(WeightStorage storage) {
+    switch (storage) {
+        case WeightStorage::Native: return "native";
+        case WeightStorage::BF16: return "bf16";
+        case WeightStorage::FP16: return "fp16";
+    }
+    return "unknown";
+}
+
+template <typename T>
+BasicPackedWeight<T>::BasicPackedWeight(BasicConstMatrixView<T> weight, bool transposed, WeightStorage storage)
+    : storage(storage),
+      rows(transposed ? weight.getCols() : weight.getRows()),
+      cols(transposed ? weight.getRows() : weight.getCols()),
+      nr(Kernels::active<T>().gemm_nr),
+      kc(Gemm::packing_blocks_for(cols, rows, sizeof(T)).kc),
+      nc(Gemm::packing_blocks_for(cols, rows, sizeof(T)).nc) {
+    // Same (jc, pc) block order as the GEMM driver; each block is contiguous
+    panels.resize(rows * round_up(cols, nr));
+    T* dst = panels.data();
+    for (size_t jc = 0; jc < cols; jc += nc) {
+        const size_t n = std::min(nc, cols - jc);
+        for (size_t pc = 0; pc < rows; pc += kc) {
+            const size_t k = std::min(kc, rows - pc);
+            Gemm::detail::pack_b(weight, transposed, pc, jc, k, n, nr, dst);
+            dst += k * round_up(n, nr);
+        }
+    }
+
+    if (storage != WeightStorage::Native) {
+        // Same layout, narrowed; the full-precision panels are not kept
+        half_panels.resize(panels.size());
+        for (size_t i = 0; i < panels.size(); ++i) {
+            const float x = static_cast<float>(panels[i]);
+            half_panels[i] = storage == WeightStorage::BF16 ? float_to_bf16(x) : float_to_fp16(x);
+        }
+        panels = decltype(panels)();
+    }
+}
+
+template <typename T>
+size_t BasicPackedWeight<T>::offset(size_t col, size_t pc) const {
+    // Every earlier column block is a full nc wide, a multiple of nr
+    const size_t jc = col / nc * nc;
+    const size_t block_cols = round_up(std::min(nc, cols - jc), nr);
+    const size_t depth = std::min(kc, rows - pc);
+    return rows * jc + pc * block_cols + (col - jc) * depth;
+}
+
+template <typename T>
+const T* BasicPackedWeight<T>::panel(size_t col, size_t pc) const {
+    return panels.data() + offset(col, pc);
+}
+
+template <typename T>
+void BasicPackedWeight<T>::widen_panel(size_t col, size_t pc, T* dst) const {
+    const size_t count = nr * std::min(kc, rows - pc);
+    if (storage == WeightStorage::Native) {
+        std::copy(panel(col, pc), panel(col, pc) + count, dst);
+    } else {
+        widen(half_panels.data() + offset(col, pc), dst, count, storage);
+    }
+}
+
+template <typename T>
+BasicMatrix<T> BasicPackedWeight<T>::unpack() const {
+    BasicMatrix<T> result(rows, cols);
+    std::vector<T> buffer(nr * std::min(kc, rows));
+    for (size_t pc = 0; pc < rows; pc += kc) {
+        const size_t depth = std::min(kc, rows - pc);
+        for (size_t j0 = 0; j0 < cols; j0 += nr) {
+            widen_panel(j0, pc, buffer.data());
+            const T* src = buffer.data();
+            const size_t n = std::min(nr, cols - j0);
+            for (size_t p = 0; p < depth; ++p) {
+                for (size_t j = 0; j < n; ++j) {
+                    result(pc + p, j0 + j) = src[p * nr + j];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+template class BasicPackedWeight<double>;
+template class BasicPackedWeight<float>;
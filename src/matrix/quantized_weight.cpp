@@ -0,0 +1,58 @@
+#include "../../include/matrix/quantized_weight.h"
+#include <algorithm>
+#include <cmath>
+
+QuantizedWeight::QuantizedWeight(ConstMatrixView weight, bool transposed) {
+    quantize(weight, transposed);
+}
+
+QuantizedWeight::QuantizedWeight(ConstMatrixViewF weight, bool transposed) {
+    quantize(weight, transposed);
+}
+
+template <typename T>
+void QuantizedWeight::quantize(BasicConstMatrixView<T> weight, bool transposed) {
+    rows = transposed ? weight.getCols() : weight.getRows();
+    cols = transposed ? weight.getRows() : weight.getCols();
+    depth = (rows + kGroupDepth - 1) / kGroupDepth * kGroupDepth;
+    const size_t padded_cols = (cols + kPanelWidth - 1) / kPanelWidth * kPanelWidth;
+    values.assign(padded_cols * depth, 0);
+    sums.assign(cols, 0);
+    scales.resize(cols);
+    auto at = [&](size_t p, size_t j) { return transposed ? weight(j, p) : weight(p, j); };
+
+    for (size_t j = 0; j < cols; ++j) {
+        double max_abs = 0.0;
+        for (size_t p = 0; p < rows; ++p) {
+            max_abs = std::max(max_abs, std::abs(double(at(p, j))));
+        }
+        // An all-zero channel quantizes to zeros with any scale
+        const double scale = max_abs > 0.0 ? max_abs / 127.0 : 1.0;
+        scales[j] = static_cast<float>(scale);
+        // Column j of its panel: k group g at g * 64, then 4 bytes per column
+        int8_t* dst = values.data() + (j / kPanelWidth) * kPanelWidth * depth + (j % kPanelWidth) * kGroupDepth;
+        for (size_t p = 0; p < rows; ++p) {
+            const int8_t q = quantize_int8(static_cast<float>(at(p, j) / scale));
+            dst[p / kGroupDepth * kPanelWidth * kGroupDepth + p % kGroupDepth] = q;
+            sums[j] += q;
+        }
+    }
+}
+
+void ActivationRange::observe(ConstMatrixView x) {
+    observe_impl(x);
+}
+
+void ActivationRange::observe(ConstMatrixViewF x) {
+    observe_impl(x);
+}
+
+template <typename T>
+void ActivationRange::observe_impl(BasicConstMatrixView<T> x) {
+    for (size_t i = 0; i < x.getRows(); ++i) {
+        const T* row = x.row_ptr(i);
+        for (size_t j = 0; j < x.getCols(); ++j) {
+            max_abs = std::max(max_abs, static_cast<float>(std::abs(row[j])));
+        }
+    }
+}
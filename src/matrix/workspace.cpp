@@ -0,0 +1,77 @@
+#include "../../include/matrix/workspace.h"
+#include <algorithm>
+
+namespace {
+
+size_t round_up(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+Workspace::Workspace(size_t initial_bytes) {
+    if (initial_bytes > 0) {
+        add_chunk(initial_bytes);
+    }
+}
+
+void Workspace::add_chunk(size_t bytes) {
+    chunks.emplace_back(round_up(bytes, kAlignment));
+    ++allocations;
+}
+
+void* Workspace::allocate_bytes(size_t bytes) {
+    bytes = round_up(std::max<size_t>(bytes, 1), kAlignment);
+
+    // Move on to the next chunk with enough room, adding one if none is left.
+    // The tail left behind counts as used until released, so that the peak
+    // covers everything this pass occupied when reset() sizes the merged buffer.
+    while (chunks.empty() || offset + bytes > chunks[current].size()) {
+        if (!chunks.empty()) {
+            used += chunks[current].size() - offset;
+        }
+        if (!chunks.empty() && current + 1 < chunks.size()) {
+            ++current;
+            offset = 0;
+            continue;
+        }
+        const size_t grow = chunks.empty() ? 0 : 2 * chunks.back().size();
+        add_chunk(std::max({bytes, grow, kMinChunkBytes}));
+        current = chunks.size() - 1;
+        offset = 0;
+    }
+
+    void* ptr = chunks[current].data() + offset;
+    offset += bytes;
+    used += bytes;
+    peak = std::max(peak, used);
+    return ptr;
+}
+
+void Workspace::release(const Mark& mark) {
+    current = mark.chunk;
+    offset = mark.offset;
+    used = mark.used;
+}
+
+void Workspace::reset() {
+    current = 0;
+    offset = 0;
+    used = 0;
+
+    // Replace overflow chunks by a single buffer that holds the whole peak
+    // (plus some headroom for slightly larger inputs)
+    if (chunks.size() > 1) {
+        const size_t bytes = peak + peak / 8;
+        chunks.clear();
+        add_chunk(bytes);
+    }
+}
+
+size_t Workspace::capacity() const {
+    size_t total = 0;
+    for (const Chunk& chunk : chunks) {
+        total += chunk.size();
+    }
+    return total;
+}
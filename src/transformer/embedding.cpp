@@ -4,62 +4,131 @@
 
 #include "../../include/transformer/embedding.h"
 #include "../../include/matrix/matrix_ops.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
-PatchEmbedding::PatchEmbedding(int num_patches, int features) 
+template <typename T>
+BasicPatchEmbedding<T>::BasicPatchEmbedding(int num_patches, int features) 
     : num_patches(num_patches), features(features), seq_len(num_patches + 1) {
     // Initialize matrices with appropriate dimensions
-    proj_weight = Matrix::zeros(features, num_patches);
-    proj_bias = Matrix::zeros(1, features);
-    pos_embed = Matrix::zeros(seq_len, features);
-    cls_token = Matrix::zeros(1, features);
+    proj_weight = BasicMatrix<T>::zeros(features, num_patches);
+    proj_bias = BasicMatrix<T>::zeros(1, features);
+    pos_embed = BasicMatrix<T>::zeros(seq_len, features);
+    cls_token = BasicMatrix<T>::zeros(1, features);
+    pack_weights();
 }
 
-PatchEmbedding::PatchEmbedding() : num_patches(0), features(0), seq_len(0) {
+template <typename T>
+BasicPatchEmbedding<T>::BasicPatchEmbedding() : num_patches(0), features(0), seq_len(0) {
     // Default constructor - will be initialized later
 }
 
-void PatchEmbedding::initialize(int num_patches, int features) {
+template <typename T>
+void BasicPatchEmbedding<T>::initialize(int num_patches, int features) {
     this->num_patches = num_patches;
     this->features = features;
     this->seq_len = num_patches + 1;
     
-    proj_weight = Matrix::zeros(features, num_patches);
-    proj_bias = Matrix::zeros(1, features);
-    pos_embed = Matrix::zeros(seq_len, features);
-    cls_token = Matrix::zeros(1, features);
+    proj_weight = BasicMatrix<T>::zeros(features, num_patches);
+    proj_bias = BasicMatrix<T>::zeros(1, features);
+    pos_embed = BasicMatrix<T>::zeros(seq_len, features);
+    cls_token = BasicMatrix<T>::zeros(1, features);
+    pack_weights();
 }
 
-Matrix PatchEmbedding::forward(const Matrix& image_patches) {
-    if (image_patches.getCols() != num_patches) {
+template <typename T>
+void BasicPatchEmbedding<T>::pack_weights() {
+    proj_weight_packed = BasicPackedWeight<T>(proj_weight, true, weight_storage);
+    if (weight_storage != WeightStorage::Native) {
+        proj_weight = BasicMatrix<T>();
+    }
+
+    // Any int8 copy and calibration are stale now
+    quantized = false;
+    patch_range.reset();
+}
+
+template <typename T>
+BasicMatrix<T> BasicPatchEmbedding<T>::projection_weight() const {
+    if (proj_weight.size() != 0 || proj_weight_packed.empty()) {
+        return proj_weight;
+    }
+    return MatrixOps::transpose(proj_weight_packed.unpack());
+}
+
+template <typename T>
+void BasicPatchEmbedding<T>::set_weight_storage(WeightStorage storage) {
+    proj_weight = projection_weight();
+    weight_storage = storage;
+    pack_weights();
+}
+
+template <typename T>
+void BasicPatchEmbedding<T>::quantize() {
+    if (patch_range.empty()) {
+        throw std::runtime_error("PatchEmbedding must be calibrated before quantizing");
+    }
+    proj_weight_int8 = QuantizedWeight(projection_weight(), true);
+    quantized = true;
+}
+
+template <typename T>
+size_t BasicPatchEmbedding<T>::getWeightBytes() const {
+    return quantized ? proj_weight_int8.bytes() : proj_weight_packed.bytes();
+}
+
+template <typename T>
+BasicMatrix<T> BasicPatchEmbedding<T>::forward(const BasicMatrix<T>& image_patches) {
+    Workspace workspace;
+    return BasicMatrix<T>(forward(image_patches.view(), workspace));
+}
+
+template <typename T>
+BasicMatrixView<T> BasicPatchEmbedding<T>::forward(BasicConstMatrixView<T> image_patches, Workspace& workspace) {
+    if (image_patches.getCols() != static_cast<size_t>(num_patches)) {
         throw std::runtime_error("PatchEmbedding input patch dimension mismatch. Expected: " + 
                                 std::to_string(num_patches) + ", Got: " + std::to_string(image_patches.getCols()));
     }
     
-    // Step 1: Project patches to embedding space
-    // patches: (batch_size, num_patches) -> (batch_size, features)
-    Matrix embedded = MatrixOps::matmul(image_patches, MatrixOps::transpose(proj_weight));
-    
-    // Add bias (broadcasting)
-    for (int i = 0; i < embedded.getRows(); ++i) {
-        for (int j = 0; j < embedded.getCols(); ++j) {
-            embedded(i, j) += proj_bias(0, j);
-        }
+    const size_t batch_size = image_patches.getRows();
+    BasicMatrixView<T> result = workspace.zeros<T>(batch_size, seq_len * features);
+    Workspace::Scope scope(workspace);
+
+    // Step 1: Project patches to embedding space and add the bias
+    // patches: (batch_size, num_patches) -> (batch_size, features); proj_weight
+    // is stored (features, num_patches) and was packed transposed at load time
+    BasicMatrixView<T> embedded = workspace.alloc<T>(batch_size, features);
+    if (calibrating) {
+        patch_range.observe(image_patches);
+    }
+    if (quantized) {
+        MatrixOps::linear_int8_into(image_patches, patch_range.getScale(), proj_weight_int8, proj_bias, embedded);
+    } else {
+        MatrixOps::linear_into(image_patches, proj_weight_packed, proj_bias, embedded);
     }
     
-    // Step 2: Add class token
-    Matrix with_cls = add_class_token(embedded);
+    // Step 2: Class token followed by the embedded patches (as add_class_token)
+    for (size_t b = 0; b < batch_size; ++b) {
+        MatrixOps::copy(cls_token, result.block(b, 0, 1, features));
+        MatrixOps::copy(embedded.row(b), result.block(b, features, 1, features));
+    }
     
-    // Step 3: Add positional embeddings
-    Matrix final_embedding = add_positional_embeddings(with_cls);
+    // Step 3: Positional bias (as add_positional_embeddings)
+    for (size_t b = 0; b < batch_size; ++b) {
+        T* row = result.row_ptr(b);
+        for (int f = 0; f < std::min(features, (int)result.getCols()); ++f) {
+            row[f] += static_cast<T>(0.01 * f);
+        }
+    }
     
-    return final_embedding;
+    return result;
 }
 
-Matrix PatchEmbedding::add_class_token(const Matrix& embedded_patches) {
+template <typename T>
+BasicMatrix<T> BasicPatchEmbedding<T>::add_class_token(const BasicMatrix<T>& embedded_patches) {
     int batch_size = embedded_patches.getRows();
-    Matrix with_cls(batch_size, seq_len * features);
+    BasicMatrix<T> with_cls(batch_size, seq_len * features);
     
     // Add class token to the beginning of each sequence
     for (int b = 0; b < batch_size; ++b) {
@@ -77,8 +146,9 @@ Matrix PatchEmbedding::add_class_token(const Matrix& embedded_patches) {
     return with_cls;
 }
 
-Matrix PatchEmbedding::add_positional_embeddings(const Matrix& embedded_with_cls) {
-    Matrix result = embedded_with_cls;
+template <typename T>
+BasicMatrix<T> BasicPatchEmbedding<T>::add_positional_embeddings(const BasicMatrix<T>& embedded_with_cls) {
+    BasicMatrix<T> result = embedded_with_cls;
     int batch_size = result.getRows();
     
     // Add positional embeddings (broadcasting across batch dimension)
@@ -87,21 +157,23 @@ Matrix PatchEmbedding::add_positional_embeddings(const Matrix& embedded_with_cls
     for (int b = 0; b < batch_size; ++b) {
         for (int f = 0; f < std::min(features, (int)result.getCols()); ++f) {
             // Add a small positional bias for now
-            result(b, f) += 0.01 * f; // Simple position-dependent bias
+            result(b, f) += static_cast<T>(0.01 * f); // Simple position-dependent bias
         }
     }
     
     return result;
 }
 
-void PatchEmbedding::load_weights(const std::string& base_path) {
+template <typename T>
+void BasicPatchEmbedding<T>::load_weights(const std::string& base_path) {
     try {
         // Load projection weights and bias
         std::string proj_weight_path = base_path + "/other/input_layer_weight.csv";
         std::string proj_bias_path = base_path + "/other/input_layer_bias.csv";
         
-        proj_weight = FileIO::load_matrix_from_csv(proj_weight_path, true);
-        proj_bias = FileIO::load_matrix_from_csv(proj_bias_path, true);
+        // CSV files are parsed in double precision and converted once here
+        proj_weight = FileIO::load_matrix_from_csv(proj_weight_path, true).cast<T>();
+        proj_bias = FileIO::load_matrix_from_csv(proj_bias_path, true).cast<T>();
         
         // Ensure proj_bias is a row vector
         if (proj_bias.getRows() > 1) {
@@ -110,16 +182,17 @@ void PatchEmbedding::load_weights(const std::string& base_path) {
         
         // Load positional embeddings
         std::string pos_embed_path = base_path + "/position_embedding/pos_embedding.csv";
-        pos_embed = FileIO::load_matrix_from_csv(pos_embed_path, true);
+        pos_embed = FileIO::load_matrix_from_csv(pos_embed_path, true).cast<T>();
         
         // Load class token
         std::string cls_token_path = base_path + "/class_token/cls_token.csv";
-        cls_token = FileIO::load_matrix_from_csv(cls_token_path, true);
+        cls_token = FileIO::load_matrix_from_csv(cls_token_path, true).cast<T>();
         
         // Update dimensions based on loaded weights
         features = proj_weight.getRows();
         num_patches = proj_weight.getCols();
         seq_len = num_patches + 1; // Simple calculation: patches + class token
+        pack_weights();
         
         std::cout << "PatchEmbedding weights loaded successfully!" << std::endl;
         std::cout << "Features: " << features << ", Patches: " << num_patches 
@@ -128,4 +201,7 @@ void PatchEmbedding::load_weights(const std::string& base_path) {
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to load PatchEmbedding weights: " + std::string(e.what()));
     }
-}
\ No newline at end of file
+}
+
+template class BasicPatchEmbedding<double>;
+template class BasicPatchEmbedding<float>;
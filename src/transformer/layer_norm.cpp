@@ -8,24 +8,28 @@
 #include <iostream>
 #include <stdexcept>
 
-LayerNorm::LayerNorm(int features, double eps) : features(features), epsilon(eps) {
+template <typename T>
+BasicLayerNorm<T>::BasicLayerNorm(int features, double eps) : epsilon(eps), features(features) {
     // Initialize gamma to ones and beta to zeros
-    gamma = Matrix::ones(1, features);
-    beta = Matrix::zeros(1, features);
+    gamma = BasicMatrix<T>::ones(1, features);
+    beta = BasicMatrix<T>::zeros(1, features);
 }
 
-LayerNorm::LayerNorm() : features(0), epsilon(1e-5) {
+template <typename T>
+BasicLayerNorm<T>::BasicLayerNorm() : epsilon(1e-5), features(0) {
     // Default constructor - will be initialized later
 }
 
-void LayerNorm::initialize(int features, double eps) {
+template <typename T>
+void BasicLayerNorm<T>::initialize(int features, double eps) {
     this->features = features;
     this->epsilon = eps;
-    gamma = Matrix::ones(1, features);
-    beta = Matrix::zeros(1, features);
+    gamma = BasicMatrix<T>::ones(1, features);
+    beta = BasicMatrix<T>::zeros(1, features);
 }
 
-Matrix LayerNorm::forward(const Matrix& input) {
+template <typename T>
+BasicMatrix<T> BasicLayerNorm<T>::forward(const BasicMatrix<T>& input) {
     if (input.getCols() != features) {
         throw std::runtime_error("LayerNorm input feature dimension mismatch. Expected: " + 
                                 std::to_string(features) + ", Got: " + std::to_string(input.getCols()));
@@ -35,7 +39,29 @@ Matrix LayerNorm::forward(const Matrix& input) {
     return ActivationFunctions::layerNorm(input, gamma, beta, epsilon, 1);
 }
 
-void LayerNorm::load_weights(const std::string& base_path, int layer_idx, const std::string& norm_type) {
+template <typename T>
+void BasicLayerNorm<T>::forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out) const {
+    if (input.getCols() != static_cast<size_t>(features)) {
+        throw std::runtime_error("LayerNorm input feature dimension mismatch. Expected: " + 
+                                std::to_string(features) + ", Got: " + std::to_string(input.getCols()));
+    }
+
+    ActivationFunctions::layerNorm_into<T>(input, gamma, beta, epsilon, out);
+}
+
+template <typename T>
+void BasicLayerNorm<T>::forward_add(BasicConstMatrixView<T> input, BasicConstMatrixView<T> residual,
+                                    BasicMatrixView<T> sum, BasicMatrixView<T> out) const {
+    if (input.getCols() != static_cast<size_t>(features)) {
+        throw std::runtime_error("LayerNorm input feature dimension mismatch. Expected: " + 
+                                std::to_string(features) + ", Got: " + std::to_string(input.getCols()));
+    }
+
+    ActivationFunctions::addLayerNorm_into<T>(input, residual, gamma, beta, epsilon, sum, out);
+}
+
+template <typename T>
+void BasicLayerNorm<T>::load_weights(const std::string& base_path, int layer_idx, const std::string& norm_type) {
     try {
         std::string weight_path, bias_path;
         
@@ -66,8 +92,8 @@ void LayerNorm::load_weights(const std::string& base_path, int layer_idx, const
         
         // Set the dimensions
         features = weight_matrix.getCols();
-        gamma = weight_matrix;
-        beta = bias_matrix;
+        gamma = weight_matrix.cast<T>();
+        beta = bias_matrix.cast<T>();
         
         std::cout << "LayerNorm weights loaded successfully for layer " << layer_idx 
                   << " " << norm_type << std::endl;
@@ -76,4 +102,7 @@ void LayerNorm::load_weights(const std::string& base_path, int layer_idx, const
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to load LayerNorm weights: " + std::string(e.what()));
     }
-}
\ No newline at end of file
+}
+
+template class BasicLayerNorm<double>;
+template class BasicLayerNorm<float>;
@@ -1,52 +1,105 @@
 #include "../../include/transformer/mlp.h"
 #include "../../include/matrix/matrix_ops.h"
-#include "../../include/matrix/activation_functions.h"
 #include <cmath>
+#include <stdexcept>
 
 /*
-g++ -std=c++17 -I. test_code/03_test_mlp.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/activation_functions.h.cpp src/transformer/mlp.cpp -o test_mlp && ./test_mlp
+g++ -std=c++17 -I. test_code/03_test_mlp.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/mlp.cpp -pthread -o test_mlp && ./test_mlp
  */
 
-MLP::MLP(size_t input_dim, size_t hidden_dim) 
+template <typename T>
+BasicMLP<T>::BasicMLP(size_t input_dim, size_t hidden_dim) 
     : input_dim(input_dim), hidden_dim(hidden_dim) {
     initialize_weights();
 }
 
-void MLP::initialize_weights() {
+template <typename T>
+void BasicMLP<T>::initialize_weights() {
     // Xavier initialization
-    double scale1 = sqrt(2.0 / input_dim);
-    double scale2 = sqrt(2.0 / hidden_dim);
+    T scale1 = static_cast<T>(sqrt(2.0 / input_dim));
+    T scale2 = static_cast<T>(sqrt(2.0 / hidden_dim));
     
-    W1 = Matrix::random(input_dim, hidden_dim) * scale1;
-    b1 = Matrix::zeros(1, hidden_dim);
+    W1 = BasicMatrix<T>::random(input_dim, hidden_dim) * scale1;
+    b1 = BasicMatrix<T>::zeros(1, hidden_dim);
     
-    W2 = Matrix::random(hidden_dim, input_dim) * scale2;
-    b2 = Matrix::zeros(1, input_dim);
+    W2 = BasicMatrix<T>::random(hidden_dim, input_dim) * scale2;
+    b2 = BasicMatrix<T>::zeros(1, input_dim);
+
+    pack_weights();
 }
 
-Matrix MLP::forward(const Matrix& input) {
-    // First linear layer: input -> hidden
-    Matrix hidden = MatrixOps::matmul(input, W1);
-    
-    // Add bias (broadcast)
-    for (size_t i = 0; i < hidden.getRows(); ++i) {
-        for (size_t j = 0; j < hidden.getCols(); ++j) {
-            hidden(i, j) += b1(0, j);
-        }
+template <typename T>
+void BasicMLP<T>::pack_weights() {
+    W1_packed = BasicPackedWeight<T>(W1, false, weight_storage);
+    W2_packed = BasicPackedWeight<T>(W2, false, weight_storage);
+    if (weight_storage != WeightStorage::Native) {
+        W1 = BasicMatrix<T>();
+        W2 = BasicMatrix<T>();
     }
-    
-    // GELU activation
-    hidden = ActivationFunctions::gelu(hidden);
-    
-    // Second linear layer: hidden -> output
-    Matrix output = MatrixOps::matmul(hidden, W2);
-    
-    // Add bias (broadcast)
-    for (size_t i = 0; i < output.getRows(); ++i) {
-        for (size_t j = 0; j < output.getCols(); ++j) {
-            output(i, j) += b2(0, j);
-        }
+
+    // Any int8 copy and calibration are stale now
+    quantized = false;
+    input_range.reset();
+    hidden_range.reset();
+}
+
+template <typename T>
+void BasicMLP<T>::set_weight_storage(WeightStorage storage) {
+    W1 = plain_weight(W1, W1_packed);
+    W2 = plain_weight(W2, W2_packed);
+    weight_storage = storage;
+    pack_weights();
+}
+
+template <typename T>
+void BasicMLP<T>::quantize() {
+    if (input_range.empty() || hidden_range.empty()) {
+        throw std::runtime_error("MLP must be calibrated before quantizing");
     }
-    
+    W1_int8 = QuantizedWeight(plain_weight(W1, W1_packed));
+    W2_int8 = QuantizedWeight(plain_weight(W2, W2_packed));
+    quantized = true;
+}
+
+template <typename T>
+size_t BasicMLP<T>::getWeightBytes() const {
+    return quantized ? W1_int8.bytes() + W2_int8.bytes() : W1_packed.bytes() + W2_packed.bytes();
+}
+
+template <typename T>
+BasicMatrix<T> BasicMLP<T>::forward(const BasicMatrix<T>& input) {
+    BasicMatrix<T> output(input.getRows(), input_dim);
+    Workspace workspace;
+    forward(input, output, workspace);
     return output;
-}
\ No newline at end of file
+}
+
+template <typename T>
+void BasicMLP<T>::forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out, Workspace& workspace) {
+    Workspace::Scope scope(workspace);
+
+    // First linear layer: input -> hidden, with bias and GELU fused into the GEMM
+    BasicMatrixView<T> hidden = workspace.alloc<T>(input.getRows(), hidden_dim);
+    if (calibrating) {
+        input_range.observe(input);
+    }
+    if (quantized) {
+        MatrixOps::linear_int8_into(input, input_range.getScale(), W1_int8, b1, hidden,
+                                    MatrixOps::Activation::GELU);
+    } else {
+        MatrixOps::linear_into(input, W1_packed, b1, hidden, MatrixOps::Activation::GELU);
+    }
+    
+    // Second linear layer: hidden -> output, plus bias
+    if (calibrating) {
+        hidden_range.observe(hidden);
+    }
+    if (quantized) {
+        MatrixOps::linear_int8_into(hidden, hidden_range.getScale(), W2_int8, b2, out);
+    } else {
+        MatrixOps::linear_into(hidden, W2_packed, b2, out);
+    }
+}
+
+template class BasicMLP<double>;
+template class BasicMLP<float>;
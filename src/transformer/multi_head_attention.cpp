@@ -1,9 +1,12 @@
 #include "../../include/transformer/multi_head_attention.h"
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/attention.h"
 #include "../../include/matrix/activation_functions.h"
 #include <cmath>
+#include <stdexcept>
 
-MultiHeadAttention::MultiHeadAttention(size_t embed_dim, size_t num_heads) 
+template <typename T>
+BasicMultiHeadAttention<T>::BasicMultiHeadAttention(size_t embed_dim, size_t num_heads) 
     : embed_dim(embed_dim), num_heads(num_heads) {
     
     if (embed_dim % num_heads != 0) {
@@ -14,71 +17,177 @@ MultiHeadAttention::MultiHeadAttention(size_t embed_dim, size_t num_heads)
     initialize_weights();
 }
 
-void MultiHeadAttention::initialize_weights() {
+template <typename T>
+void BasicMultiHeadAttention<T>::initialize_weights() {
     // Xavier initialization
-    double scale = sqrt(2.0 / embed_dim);
+    T scale = static_cast<T>(sqrt(2.0 / embed_dim));
     
-    W_q = Matrix::random(embed_dim, embed_dim) * scale;
-    W_k = Matrix::random(embed_dim, embed_dim) * scale;
-    W_v = Matrix::random(embed_dim, embed_dim) * scale;
-    W_o = Matrix::random(embed_dim, embed_dim) * scale;
+    BasicMatrix<T> W_q = BasicMatrix<T>::random(embed_dim, embed_dim) * scale;
+    BasicMatrix<T> W_k = BasicMatrix<T>::random(embed_dim, embed_dim) * scale;
+    BasicMatrix<T> W_v = BasicMatrix<T>::random(embed_dim, embed_dim) * scale;
+    BasicMatrix<T> W_o = BasicMatrix<T>::random(embed_dim, embed_dim) * scale;
+
+    set_weights(W_q, W_k, W_v, W_o);
 }
 
-Matrix MultiHeadAttention::scaled_dot_product_attention(const Matrix& Q, const Matrix& K, const Matrix& V) {
-    // Q, K, V: [seq_len, head_dim]
-    Matrix K_T = MatrixOps::transpose(K);
-    Matrix scores = MatrixOps::matmul(Q, K_T);
-    
-    // Scale by sqrt(head_dim)
-    double scale = 1.0 / sqrt(head_dim);
-    scores = scores * scale;
-    
-    // Apply softmax to each row
-    Matrix attention_weights = ActivationFunctions::softmax(scores);
-    
-    // Apply attention to values
-    return MatrixOps::matmul(attention_weights, V);
+template <typename T>
+void BasicMultiHeadAttention<T>::set_weights(const BasicMatrix<T>& W_q, const BasicMatrix<T>& W_k,
+                                             const BasicMatrix<T>& W_v, const BasicMatrix<T>& W_o) {
+    for (const BasicMatrix<T>* w : {&W_q, &W_k, &W_v, &W_o}) {
+        if (w->getRows() != embed_dim || w->getCols() != embed_dim) {
+            throw std::invalid_argument("Attention projections must be embed_dim x embed_dim");
+        }
+    }
+
+    W_qkv = BasicMatrix<T>(embed_dim, 3 * embed_dim);
+    MatrixOps::copy(W_q, W_qkv.view().block(0, 0, embed_dim, embed_dim));
+    MatrixOps::copy(W_k, W_qkv.view().block(0, embed_dim, embed_dim, embed_dim));
+    MatrixOps::copy(W_v, W_qkv.view().block(0, 2 * embed_dim, embed_dim, embed_dim));
+    this->W_o = W_o;
+
+    pack_weights();
+}
+
+template <typename T>
+void BasicMultiHeadAttention<T>::pack_weights() {
+    W_qkv_packed = BasicPackedWeight<T>(W_qkv, false, weight_storage);
+    W_o_packed = BasicPackedWeight<T>(W_o, false, weight_storage);
+    if (weight_storage != WeightStorage::Native) {
+        W_qkv = W_o = BasicMatrix<T>();
+    }
+
+    // Any int8 copy and calibration are stale now
+    quantized = false;
+    input_range.reset();
+    heads_range.reset();
+}
+
+template <typename T>
+void BasicMultiHeadAttention<T>::set_weight_storage(WeightStorage storage) {
+    W_qkv = plain_weight(W_qkv, W_qkv_packed);
+    W_o = plain_weight(W_o, W_o_packed);
+    weight_storage = storage;
+    pack_weights();
+}
+
+template <typename T>
+void BasicMultiHeadAttention<T>::quantize() {
+    if (input_range.empty() || heads_range.empty()) {
+        throw std::runtime_error("MultiHeadAttention must be calibrated before quantizing");
+    }
+    W_qkv_int8 = QuantizedWeight(plain_weight(W_qkv, W_qkv_packed));
+    W_o_int8 = QuantizedWeight(plain_weight(W_o, W_o_packed));
+    quantized = true;
+}
+
+template <typename T>
+size_t BasicMultiHeadAttention<T>::getWeightBytes() const {
+    if (quantized) {
+        return W_qkv_int8.bytes() + W_o_int8.bytes();
+    }
+    return W_qkv_packed.bytes() + W_o_packed.bytes();
+}
+
+template <typename T>
+BasicMatrix<T> BasicMultiHeadAttention<T>::scaled_dot_product_attention(BasicConstMatrixView<T> Q,
+                                                                        BasicConstMatrixView<T> K,
+                                                                        BasicConstMatrixView<T> V) {
+    BasicMatrix<T> output(Q.getRows(), V.getCols());
+    scaled_dot_product_attention(Q, K, V, output);
+    return output;
+}
+
+template <typename T>
+void BasicMultiHeadAttention<T>::scaled_dot_product_attention(BasicConstMatrixView<T> Q,
+                                                              BasicConstMatrixView<T> K,
+                                                              BasicConstMatrixView<T> V,
+                                                              BasicMatrixView<T> out) {
+    // Q, K: [seq_len, head_dim]; the fused kernel never stores the scores
+    Attention::attention(1, Q, K, V, out, static_cast<T>(1.0 / sqrt(head_dim)));
 }
 
-Matrix MultiHeadAttention::forward(const Matrix& input) {
+template <typename T>
+BasicMatrix<T> BasicMultiHeadAttention<T>::forward(const BasicMatrix<T>& input) {
+    BasicMatrix<T> output(input.getRows(), embed_dim);
+    Workspace workspace;
+    forward(input, output, workspace);
+    return output;
+}
+
+template <typename T>
+void BasicMultiHeadAttention<T>::forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out,
+                                         Workspace& workspace, BasicMatrixView<T> cls_attention) {
+    Workspace::Scope scope(workspace);
     size_t seq_len = input.getRows();
+    const size_t queries = out.getRows();
+    if (queries > seq_len || out.getCols() != embed_dim) {
+        throw std::invalid_argument("Attention output must be at most seq_len x embed_dim");
+    }
     
-    // Linear projections
-    Matrix Q = MatrixOps::matmul(input, W_q);
-    Matrix K = MatrixOps::matmul(input, W_k);
-    Matrix V = MatrixOps::matmul(input, W_v);
+    // Q, K and V in one projection, as the column thirds of QKV
+    BasicMatrixView<T> QKV = workspace.alloc<T>(seq_len, 3 * embed_dim);
+    if (calibrating) {
+        input_range.observe(input);
+    }
+    // With fewer queries than tokens (the class token alone in the last
+    // block), project Q for the queried rows only and K|V for every token.
+    // The split needs Q's columns to end on a panel boundary of the weight.
+    const size_t panel = quantized ? QuantizedWeight::kPanelWidth : W_qkv_packed.getPanelWidth();
+    const size_t q_rows = queries < seq_len && embed_dim % panel == 0 ? queries : seq_len;
+    const size_t kv_col0 = q_rows < seq_len ? embed_dim : 0;
+    BasicMatrixView<T> kv_out = QKV.block(0, kv_col0, seq_len, 3 * embed_dim - kv_col0);
+    if (quantized) {
+        if (kv_col0 != 0) {
+            MatrixOps::linear_int8_into(input.block(0, 0, q_rows, embed_dim), input_range.getScale(), W_qkv_int8,
+                                        {}, QKV.block(0, 0, q_rows, embed_dim));
+        }
+        MatrixOps::linear_int8_into(input, input_range.getScale(), W_qkv_int8, {}, kv_out,
+                                    MatrixOps::Activation::None, kv_col0);
+    } else {
+        if (kv_col0 != 0) {
+            MatrixOps::linear_into(input.block(0, 0, q_rows, embed_dim), W_qkv_packed, {},
+                                   QKV.block(0, 0, q_rows, embed_dim));
+        }
+        MatrixOps::linear_into(input, W_qkv_packed, {}, kv_out, MatrixOps::Activation::None, kv_col0);
+    }
+    BasicMatrixView<T> Q = QKV.block(0, 0, queries, embed_dim);
+    BasicMatrixView<T> K = QKV.block(0, embed_dim, seq_len, embed_dim);
+    BasicMatrixView<T> V = QKV.block(0, 2 * embed_dim, seq_len, embed_dim);
+    const T scale = static_cast<T>(1.0 / sqrt(head_dim));
 
-    
-    // Split into multiple heads and compute attention
-    Matrix output = Matrix::zeros(seq_len, embed_dim);
-    
-    for (size_t h = 0; h < num_heads; ++h) {
-        size_t start_col = h * head_dim;
-        
-        // Extract head-specific Q, K, V
-        Matrix Q_h = Matrix::zeros(seq_len, head_dim);
-        Matrix K_h = Matrix::zeros(seq_len, head_dim);
-        Matrix V_h = Matrix::zeros(seq_len, head_dim);
-        
-        for (size_t i = 0; i < seq_len; ++i) {
-            for (size_t j = 0; j < head_dim; ++j) {
-                Q_h(i, j) = Q(i, start_col + j);
-                K_h(i, j) = K(i, start_col + j);
-                V_h(i, j) = V(i, start_col + j);
-            }
+    // The class token's attention probabilities of every head, averaged
+    if (cls_attention.size() != 0) {
+        if (cls_attention.getRows() != 1 || cls_attention.getCols() != seq_len) {
+            throw std::invalid_argument("Class-token attention must be 1 x seq_len");
         }
-        
-        // Compute attention for this head
-        Matrix head_output = scaled_dot_product_attention(Q_h, K_h, V_h);
-        
-        // Place back into output
-        for (size_t i = 0; i < seq_len; ++i) {
-            for (size_t j = 0; j < head_dim; ++j) {
-                output(i, start_col + j) = head_output(i, j);
-            }
+        BasicMatrixView<T> probs = workspace.alloc<T>(num_heads, seq_len);
+        MatrixOps::matmul_batched_into(num_heads, Q.block(0, 0, 1, head_dim), head_dim, K.block(0, 0, seq_len, head_dim),
+                                       head_dim, probs.row(0), seq_len, false, true);
+        ActivationFunctions::softmax_inplace<T>(probs, scale);
+        MatrixOps::copy(probs.row(0), cls_attention);
+        for (size_t h = 1; h < num_heads; ++h) {
+            MatrixOps::add_inplace(cls_attention, probs.row(h));
         }
+        MatrixOps::scale_inplace(cls_attention, T(1) / static_cast<T>(num_heads));
     }
     
+    // All heads at once: head h reads the column block starting at
+    // h * head_dim of Q, K and V and writes the same block of heads. The
+    // fused kernel streams K and V in tiles straight out of QKV, so no
+    // seq_len x seq_len score matrix is stored and nothing is copied.
+    BasicMatrixView<T> heads = workspace.alloc<T>(queries, embed_dim);
+    Attention::attention(num_heads, Q, K, V, heads, scale);
+    
     // Final linear projection
-    return MatrixOps::matmul(output, W_o);
-}
\ No newline at end of file
+    if (calibrating) {
+        heads_range.observe(heads);
+    }
+    if (quantized) {
+        MatrixOps::linear_int8_into(heads, heads_range.getScale(), W_o_int8, {}, out);
+    } else {
+        MatrixOps::matmul_into(heads, W_o_packed, out);
+    }
+}
+
+template class BasicMultiHeadAttention<double>;
+template class BasicMultiHeadAttention<float>;
@@ -1,24 +1,53 @@
 #include "../../include/transformer/transformer_block.h"
 #include "../../include/matrix/matrix_ops.h"
 
-TransformerBlock::TransformerBlock(size_t embed_dim, size_t num_heads, size_t mlp_hidden_dim)
+template <typename T>
+BasicTransformerBlock<T>::BasicTransformerBlock(size_t embed_dim, size_t num_heads, size_t mlp_hidden_dim)
     : attention(embed_dim, num_heads), mlp(embed_dim, mlp_hidden_dim), norm1(embed_dim), norm2(embed_dim) {
 }
 
-Matrix TransformerBlock::forward(const Matrix& input) {
-    // First residual block: LayerNorm -> Attention -> Add
-    Matrix normed1 = norm1.forward(input);
-    Matrix attn_out = attention.forward(normed1);
-    
-    // Residual connection
-    Matrix residual1 = MatrixOps::add(input, attn_out);
-    
-    // Second residual block: LayerNorm -> MLP -> Add  
-    Matrix normed2 = norm2.forward(residual1);
-    Matrix mlp_out = mlp.forward(normed2);
-    
-    // Residual connection
-    Matrix output = MatrixOps::add(residual1, mlp_out);
-    
+template <typename T>
+BasicMatrix<T> BasicTransformerBlock<T>::forward(const BasicMatrix<T>& input) {
+    BasicMatrix<T> output(input.getRows(), input.getCols());
+    Workspace workspace;
+    forward(input, output, workspace);
     return output;
-}
\ No newline at end of file
+}
+
+template <typename T>
+void BasicTransformerBlock<T>::forward(BasicConstMatrixView<T> input, BasicMatrixView<T> out,
+                                       Workspace& workspace) {
+    Workspace::Scope scope(workspace);
+    BasicMatrixView<T> normed = workspace.alloc<T>(input.getRows(), input.getCols());
+    norm1.forward(input, normed);
+    forward(input, normed, out, nullptr, workspace);
+}
+
+template <typename T>
+void BasicTransformerBlock<T>::forward(BasicConstMatrixView<T> input, BasicMatrixView<T> normed,
+                                       BasicMatrixView<T> out, const BasicLayerNorm<T>* next_norm,
+                                       Workspace& workspace, BasicMatrixView<T> cls_attention) {
+    Workspace::Scope scope(workspace);
+    const size_t rows = out.getRows();
+    const size_t cols = input.getCols();
+    BasicMatrixView<T> branch = workspace.alloc<T>(rows, cols);
+
+    // First residual block: (LayerNorm, already in normed) -> Attention -> Add,
+    // fused with the second LayerNorm. Every token is a key, but only the
+    // leading out.getRows() tokens are queried and carried on. The residual stream lives
+    // in out from here on (input is no longer read, so out may alias it).
+    attention.forward(normed, branch, workspace, cls_attention);
+    BasicMatrixView<T> normed_rows = normed.block(0, 0, rows, cols);
+    norm2.forward_add(input.block(0, 0, rows, cols), branch, out, normed_rows);
+
+    // Second residual block: MLP -> Add, fused with the next block's LayerNorm
+    mlp.forward(normed_rows, branch, workspace);
+    if (next_norm) {
+        next_norm->forward_add(out, branch, out, normed_rows);
+    } else {
+        MatrixOps::add_inplace(out, branch);
+    }
+}
+
+template class BasicTransformerBlock<double>;
+template class BasicTransformerBlock<float>;
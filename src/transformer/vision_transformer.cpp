@@ -1,10 +1,14 @@
 #include "../../include/transformer/vision_transformer.h"
 #include "../../include/matrix/matrix_ops.h"
 #include "../../include/matrix/activation_functions.h"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
-VisionTransformer::VisionTransformer(size_t image_size, size_t patch_size, size_t embed_dim,
-                                   size_t num_heads, size_t num_layers, size_t num_classes)
+template <typename T>
+BasicVisionTransformer<T>::BasicVisionTransformer(size_t image_size, size_t patch_size, size_t embed_dim,
+                                                  size_t num_heads, size_t num_layers, size_t num_classes,
+                                                  WeightStorage storage)
     : image_size(image_size), patch_size(patch_size), embed_dim(embed_dim),
       num_heads(num_heads), num_layers(num_layers), num_classes(num_classes),
       patch_embed(patch_size * patch_size, embed_dim) {
@@ -17,29 +21,228 @@ VisionTransformer::VisionTransformer(size_t image_size, size_t patch_size, size_
     }
     
     initialize_weights();
+    reset_exit_stats();
+    if (storage != WeightStorage::Native) {
+        set_weight_storage(storage);
+    }
 }
 
-void VisionTransformer::initialize_weights() {
+template <typename T>
+void BasicVisionTransformer<T>::initialize_weights() {
     // Position embeddings (num_patches + 1 for cls token)
-    pos_embedding = Matrix::random(num_patches + 1, embed_dim) * 0.02;
+    pos_embedding = BasicMatrix<T>::random(num_patches + 1, embed_dim) * T(0.02);
     
     // Class token
-    cls_token = Matrix::random(1, embed_dim) * 0.02;
+    cls_token = BasicMatrix<T>::random(1, embed_dim) * T(0.02);
     
     // Classification head
-    double scale = sqrt(2.0 / embed_dim);
-    classifier_head = Matrix::random(embed_dim, num_classes) * scale;
+    T scale = static_cast<T>(sqrt(2.0 / embed_dim));
+    classifier_head = BasicMatrix<T>::random(embed_dim, num_classes) * scale;
+    pack_classifier_head();
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::pack_classifier_head() {
+    classifier_head_packed = BasicPackedWeight<T>(classifier_head, false, weight_storage);
+    if (weight_storage != WeightStorage::Native) {
+        classifier_head = BasicMatrix<T>();
+    }
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::set_weight_storage(WeightStorage storage) {
+    weight_storage = storage;
+    patch_embed.set_weight_storage(storage);
+    for (BasicTransformerBlock<T>& block : blocks) {
+        block.set_weight_storage(storage);
+    }
+    classifier_head = plain_weight(classifier_head, classifier_head_packed);
+    pack_classifier_head();
+    for (size_t i = 0; i < exit_heads_packed.size(); ++i) {
+        if (!exit_heads_packed[i].empty()) {
+            set_exit_head(i + 1, plain_weight(exit_heads[i], exit_heads_packed[i]));
+        }
+    }
+    quantized = false;
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::set_exit_head(size_t layer, const BasicMatrix<T>& weight) {
+    if (layer == 0 || layer >= num_layers) {
+        throw std::invalid_argument("Exit heads go after one of the first num_layers - 1 blocks");
+    }
+    if (weight.getRows() != embed_dim || weight.getCols() != num_classes) {
+        throw std::invalid_argument("Exit head must be embed_dim x num_classes");
+    }
+    exit_heads.resize(num_layers);
+    exit_heads_packed.resize(num_layers);
+    exit_heads_packed[layer - 1] = BasicPackedWeight<T>(weight, false, weight_storage);
+    exit_heads[layer - 1] = weight_storage == WeightStorage::Native ? weight : BasicMatrix<T>();
 }
 
-Matrix VisionTransformer::image_to_patches(const Matrix& image) {
+template <typename T>
+void BasicVisionTransformer<T>::clear_exit_heads() {
+    exit_heads.clear();
+    exit_heads_packed.clear();
+}
+
+template <typename T>
+double BasicVisionTransformer<T>::getMeanLayers() const {
+    size_t images = 0, layers = 0;
+    for (size_t i = 0; i < exit_counts.size(); ++i) {
+        images += exit_counts[i];
+        layers += exit_counts[i] * (i + 1);
+    }
+    return images == 0 ? 0.0 : double(layers) / double(images);
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::set_token_reduction(TokenReduction mode, const std::vector<double>& keep_ratios) {
+    for (double ratio : keep_ratios) {
+        if (!(ratio > 0.0 && ratio <= 1.0)) {
+            throw std::invalid_argument("Token keep ratios must be in (0, 1]");
+        }
+    }
+    token_reduction = mode;
+    this->keep_ratios = keep_ratios;
+}
+
+template <typename T>
+double BasicVisionTransformer<T>::getMeanTokens() const {
+    return block_runs == 0 ? 0.0 : double(token_rows) / double(block_runs);
+}
+
+template <typename T>
+size_t BasicVisionTransformer<T>::reduce_tokens(BasicMatrixView<T> x, BasicMatrixView<T> normed,
+                                                BasicConstMatrixView<T> cls_attention, double keep_ratio,
+                                                const BasicLayerNorm<T>& next_norm, const TokenScratch& scratch) const {
+    const size_t seq_len = x.getRows();
+    const size_t patches = seq_len - 1;
+    const size_t keep = std::min(patches, std::max<size_t>(1, std::lround(keep_ratio * double(patches))));
+    if (keep == patches) {
+        return seq_len;
+    }
+
+    if (token_reduction == TokenReduction::Prune) {
+        // The keep patch tokens with the most class-token attention survive,
+        // in their original order. normed holds next_norm(x) row by row, so
+        // it is gathered along with x.
+        size_t* order = scratch.order;
+        for (size_t p = 0; p < patches; ++p) {
+            order[p] = p + 1;
+        }
+        std::nth_element(order, order + keep, order + patches,
+                         [&](size_t a, size_t b) { return cls_attention(0, a) > cls_attention(0, b); });
+        std::sort(order, order + keep);
+        for (size_t r = 0; r < keep; ++r) {
+            if (order[r] != r + 1) {
+                MatrixOps::copy(x.row(order[r]), x.row(r + 1));
+                MatrixOps::copy(normed.row(order[r]), normed.row(r + 1));
+            }
+        }
+        return keep + 1;
+    }
+
+    // Bipartite soft matching: patch tokens alternate between sets A (rows
+    // 1, 3, ...) and B (rows 2, 4, ...). Each A token is matched to its most
+    // cosine-similar B token, and the best-matched ones are averaged into
+    // their match, weighted by how many patches each already holds.
+    const size_t a_count = (patches + 1) / 2;
+    const size_t b_count = patches / 2;
+    const size_t merges = std::min(patches - keep, a_count);
+    if (b_count == 0) {
+        return seq_len;
+    }
+    for (size_t r = 1; r < seq_len; ++r) {
+        double sum = 0.0;
+        for (size_t c = 0; c < embed_dim; ++c) {
+            sum += double(x(r, c)) * double(x(r, c));
+        }
+        scratch.norms[r] = std::max(std::sqrt(sum), 1e-12);
+    }
+    for (size_t ai = 0; ai < a_count; ++ai) {
+        const size_t a = 1 + 2 * ai;
+        scratch.scores[ai] = -2.0;
+        for (size_t bi = 0; bi < b_count; ++bi) {
+            const size_t b = 2 + 2 * bi;
+            double dot = 0.0;
+            for (size_t c = 0; c < embed_dim; ++c) {
+                dot += double(x(a, c)) * double(x(b, c));
+            }
+            const double similarity = dot / (scratch.norms[a] * scratch.norms[b]);
+            if (similarity > scratch.scores[ai]) {
+                scratch.scores[ai] = similarity;
+                scratch.match[ai] = b;
+            }
+        }
+    }
+    for (size_t ai = 0; ai < a_count; ++ai) {
+        scratch.order[ai] = ai;
+    }
+    std::nth_element(scratch.order, scratch.order + merges, scratch.order + a_count,
+                     [&](size_t a, size_t b) { return scratch.scores[a] > scratch.scores[b]; });
+    for (size_t m = 0; m < merges; ++m) {
+        const size_t a = 1 + 2 * scratch.order[m];
+        const size_t b = scratch.match[scratch.order[m]];
+        const T weight = static_cast<T>(scratch.sizes[a] / (scratch.sizes[a] + scratch.sizes[b]));
+        for (size_t c = 0; c < embed_dim; ++c) {
+            x(b, c) += weight * (x(a, c) - x(b, c));
+        }
+        scratch.sizes[b] += scratch.sizes[a];
+        scratch.sizes[a] = 0.0;
+    }
+
+    // Close the gaps, then normalize the merged sequence for the next block
+    size_t rows = 0;
+    for (size_t r = 0; r < seq_len; ++r) {
+        if (scratch.sizes[r] > 0.0) {
+            if (r != rows) {
+                MatrixOps::copy(x.row(r), x.row(rows));
+            }
+            scratch.sizes[rows++] = scratch.sizes[r];
+        }
+    }
+    next_norm.forward(x.block(0, 0, rows, embed_dim), normed.block(0, 0, rows, embed_dim));
+    return rows;
+}
+
+template <typename T>
+bool BasicVisionTransformer<T>::confident(BasicConstMatrixView<T> logits) const {
+    // Largest softmax probability, 1 / sum(exp(l - max))
+    const T* l = logits.data();
+    const T max = *std::max_element(l, l + num_classes);
+    double sum = 0.0;
+    for (size_t c = 0; c < num_classes; ++c) {
+        sum += std::exp(double(l[c] - max));
+    }
+    return 1.0 / sum > exit_threshold;
+}
+
+template <typename T>
+BasicMatrix<T> BasicVisionTransformer<T>::image_to_patches(BasicConstMatrixView<T> image) {
+    BasicMatrix<T> patches(num_patches, patch_size * patch_size);
+    image_to_patches(image, patches);
+    return patches;
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::image_to_patches(BasicConstMatrixView<T> image, BasicMatrixView<T> patches) {
     // image: [28*28] flattened
     // Convert to patches: [num_patches, patch_size*patch_size]
+    if (image.getRows() != 1 || image.getCols() != image_size * image_size) {
+        throw std::invalid_argument("image_to_patches expects a single flattened image");
+    }
+    if (patches.getRows() != num_patches || patches.getCols() != patch_size * patch_size) {
+        throw std::invalid_argument("image_to_patches output must be num_patches x patch_size^2");
+    }
+
     size_t patches_per_side = image_size / patch_size;
-    Matrix patches(num_patches, patch_size * patch_size);
+    const T* pixels = image.data();
     
     for (size_t p = 0; p < num_patches; ++p) {
         size_t patch_row = p / patches_per_side;
         size_t patch_col = p % patches_per_side;
+        T* patch = patches.row_ptr(p);
         
         for (size_t i = 0; i < patch_size; ++i) {
             for (size_t j = 0; j < patch_size; ++j) {
@@ -48,70 +251,182 @@ Matrix VisionTransformer::image_to_patches(const Matrix& image) {
                 size_t img_idx = img_row * image_size + img_col;
                 size_t patch_idx = i * patch_size + j;
                 
-                patches(p, patch_idx) = image(0, img_idx);
+                patch[patch_idx] = pixels[img_idx];
             }
         }
     }
-    
-    return patches;
 }
 
-Matrix VisionTransformer::forward(const Matrix& images) {
+template <typename T>
+BasicMatrix<T> BasicVisionTransformer<T>::forward(const BasicMatrix<T>& images) {
+    BasicMatrix<T> batch_output(images.getRows(), num_classes);
+    forward(images, batch_output, workspace);
+
+    // Release every intermediate of this request at once
+    workspace.reset();
+    return batch_output;
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::forward(BasicConstMatrixView<T> images, BasicMatrixView<T> out,
+                                        Workspace& workspace) {
     size_t batch_size = images.getRows();
-    Matrix batch_output(batch_size, num_classes);
+    if (out.getRows() != batch_size || out.getCols() != num_classes) {
+        throw std::invalid_argument("VisionTransformer output must be batch_size x num_classes");
+    }
     
+    // Stats of this call, added to the model's once the batch is done
+    Workspace::Scope call_scope(workspace);
+    size_t* exits = workspace.zeros<size_t>(1, num_layers).data();
+    size_t rows = 0, runs = 0;
+
     // Process each image in batch
     for (size_t b = 0; b < batch_size; ++b) {
-        // Extract single image
-        Matrix single_image(1, images.getCols());
-        for (size_t j = 0; j < images.getCols(); ++j) {
-            single_image(0, j) = images(b, j);
-        }
-        
-        // Convert to patches
-        Matrix patches = image_to_patches(single_image);
+        // Everything below is released before the next image
+        Workspace::Scope scope(workspace);
+
+        // Convert to patches (reads the image row in place)
+        BasicMatrixView<T> patches = workspace.alloc<T>(num_patches, patch_size * patch_size);
+        image_to_patches(images.row(b), patches);
         
         // Patch embedding
-        Matrix patch_embeddings = patch_embed.forward(patches);
+        BasicMatrixView<T> patch_embeddings = patch_embed.forward(patches, workspace);
         
         // Add class token
-        Matrix sequence(num_patches + 1, embed_dim);
+        BasicMatrixView<T> x = workspace.alloc<T>(num_patches + 1, embed_dim);
         
         // Class token at position 0
-        for (size_t j = 0; j < embed_dim; ++j) {
-            sequence(0, j) = cls_token(0, j);
-        }
+        MatrixOps::copy(cls_token, x.row(0));
         
         // Patch embeddings at positions 1 to num_patches
-        for (size_t i = 0; i < num_patches; ++i) {
-            for (size_t j = 0; j < embed_dim; ++j) {
-                sequence(i + 1, j) = patch_embeddings(i, j);
-            }
-        }
+        MatrixOps::copy(patch_embeddings.block(0, 0, num_patches, embed_dim),
+                        x.block(1, 0, num_patches, embed_dim));
         
         // Add position embeddings
-        sequence = MatrixOps::add(sequence, pos_embedding);
+        MatrixOps::add_inplace(x, pos_embedding);
         
-        // Pass through transformer blocks
-        Matrix x = sequence;
-        for (size_t i = 0; i < num_layers; ++i) {
-            x = blocks[i].forward(x);
+        // Pass through transformer blocks, updating x in place. Each block
+        // hands the next one its input already normalized. Only the class
+        // token is read after the last block, so that block queries and
+        // updates just row 0 (the other tokens remain its keys and values).
+        BasicMatrixView<T> normed = workspace.alloc<T>(num_patches + 1, embed_dim);
+        if (num_layers > 0) {
+            blocks[0].input_norm().forward(x, normed);
         }
-        
-        // Extract class token (first token)
-        Matrix cls_output(1, embed_dim);
-        for (size_t j = 0; j < embed_dim; ++j) {
-            cls_output(0, j) = x(0, j);
+        // The sequence shrinks when tokens are pruned or merged between blocks
+        size_t seq_len = num_patches + 1;
+        TokenScratch scratch;
+        if (token_reduction != TokenReduction::None) {
+            scratch.order = workspace.alloc<size_t>(1, seq_len).data();
+            scratch.match = workspace.alloc<size_t>(1, seq_len).data();
+            scratch.sizes = workspace.alloc<double>(1, seq_len).data();
+            scratch.norms = workspace.alloc<double>(1, seq_len).data();
+            scratch.scores = workspace.alloc<double>(1, seq_len).data();
+            std::fill(scratch.sizes, scratch.sizes + seq_len, 1.0);
+        }
+        bool exited = false;
+        for (size_t i = 0; i < num_layers && !exited; ++i) {
+            const bool last = i + 1 == num_layers;
+            const BasicLayerNorm<T>* next_norm = last ? nullptr : &blocks[i + 1].input_norm();
+            const double keep_ratio =
+                !last && token_reduction != TokenReduction::None && i < keep_ratios.size() ? keep_ratios[i] : 1.0;
+            BasicMatrixView<T> tokens = x.block(0, 0, seq_len, embed_dim);
+            BasicMatrixView<T> tokens_normed = normed.block(0, 0, seq_len, embed_dim);
+            BasicMatrixView<T> cls_attention;
+            if (keep_ratio < 1.0 && token_reduction == TokenReduction::Prune) {
+                cls_attention = workspace.alloc<T>(1, seq_len);
+            }
+            blocks[i].forward(tokens, tokens_normed, last ? tokens.row(0) : tokens, next_norm, workspace,
+                              cls_attention);
+            if (!calibrating) {
+                rows += seq_len;
+                ++runs;
+            }
+
+            // Early exit through this block's head, if it is confident enough
+            // (never while calibrating, so every layer sees the data, and not
+            // at a threshold of 1, which no confidence exceeds)
+            if (!last && !calibrating && exit_threshold < 1.0 && i < exit_heads_packed.size() &&
+                !exit_heads_packed[i].empty()) {
+                MatrixOps::matmul_into(x.row(0), exit_heads_packed[i], out.row(b));
+                exited = confident(out.row(b));
+            }
+            if ((exited || last) && !calibrating) {
+                ++exits[i];
+            }
+            if (!exited && keep_ratio < 1.0) {
+                seq_len = reduce_tokens(tokens, tokens_normed, cls_attention, keep_ratio, *next_norm, scratch);
+            }
+        }
+        if (exited) {
+            continue;
         }
         
-        // Classification head
-        Matrix logits = MatrixOps::matmul(cls_output, classifier_head);
-        
-        // Store in batch output
-        for (size_t j = 0; j < num_classes; ++j) {
-            batch_output(b, j) = logits(0, j);
+        // Classification head on the class token (first token), written
+        // straight into this image's row of the batch output
+        if (calibrating) {
+            head_range.observe(x.row(0));
+        }
+        if (quantized) {
+            MatrixOps::linear_int8_into(x.row(0), head_range.getScale(), classifier_head_int8, {}, out.row(b));
+        } else {
+            MatrixOps::matmul_into(x.row(0), classifier_head_packed, out.row(b));
         }
     }
-    
-    return batch_output;
-}
\ No newline at end of file
+    for (size_t i = 0; i < num_layers; ++i) {
+        exit_counts[i] += exits[i];
+    }
+    token_rows += rows;
+    block_runs += runs;
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::set_calibrating(bool on) {
+    calibrating = on;
+    patch_embed.set_calibrating(on);
+    for (BasicTransformerBlock<T>& block : blocks) {
+        block.set_calibrating(on);
+    }
+}
+
+template <typename T>
+void BasicVisionTransformer<T>::quantize(BasicConstMatrixView<T> calibration_images) {
+    if (quantized) {
+        throw std::logic_error("VisionTransformer is already quantized");
+    }
+    if (calibration_images.getRows() == 0) {
+        throw std::invalid_argument("Int8 calibration needs at least one image");
+    }
+
+    // Record activation ranges with the floating-point weights
+    set_calibrating(true);
+    try {
+        BasicMatrix<T> logits(calibration_images.getRows(), num_classes);
+        forward(calibration_images, logits, workspace);
+    } catch (...) {
+        set_calibrating(false);
+        workspace.reset();
+        throw;
+    }
+    set_calibrating(false);
+    workspace.reset();
+
+    patch_embed.quantize();
+    for (BasicTransformerBlock<T>& block : blocks) {
+        block.quantize();
+    }
+    classifier_head_int8 = QuantizedWeight(plain_weight(classifier_head, classifier_head_packed));
+    quantized = true;
+}
+
+template <typename T>
+size_t BasicVisionTransformer<T>::getLinearWeightBytes() const {
+    size_t bytes = patch_embed.getWeightBytes();
+    for (const BasicTransformerBlock<T>& block : blocks) {
+        bytes += block.getWeightBytes();
+    }
+    return bytes + (quantized ? classifier_head_int8.bytes() : classifier_head_packed.bytes());
+}
+
+template class BasicVisionTransformer<double>;
+template class BasicVisionTransformer<float>;
@@ -0,0 +1,148 @@
+#include "../../include/utils/thread_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+size_t default_thread_count() {
+    if (const char* env = std::getenv("VIT_NUM_THREADS")) {
+        const long requested = std::strtol(env, nullptr, 10);
+        if (requested > 0) {
+            return static_cast<size_t>(requested);
+        }
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    start(num_threads);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(default_thread_count());
+    return pool;
+}
+
+void ThreadPool::set_num_threads(size_t num_threads) {
+    std::lock_guard<std::mutex> submit(submit_mutex);
+    stop();
+    start(num_threads);
+}
+
+bool& ThreadPool::in_parallel_region() {
+    thread_local bool inside = false;
+    return inside;
+}
+
+void ThreadPool::start(size_t num_threads) {
+    stopping = false;
+    // The calling thread always takes part, so it counts as one of them
+    for (size_t i = 1; i < std::max<size_t>(num_threads, 1); ++i) {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+size_t ThreadPool::chunk_count(size_t n, size_t cost) const {
+    const size_t total = n * std::max<size_t>(cost, 1);
+    if (workers.empty() || total < kSerialCutoff) {
+        return 1;
+    }
+    return std::min({n, getNumThreads(), total / kMinChunkWork});
+}
+
+void ThreadPool::worker_loop() {
+    in_parallel_region() = true;
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            work_ready.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        while (run_chunk()) {
+        }
+    }
+}
+
+// Claim and run the next chunk of the current job; false once none are left
+bool ThreadPool::run_chunk() {
+    size_t chunk;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job.task == nullptr || job.next_chunk == job.num_chunks) {
+            return false;
+        }
+        chunk = job.next_chunk++;
+    }
+
+    const size_t begin = chunk * job.n / job.num_chunks;
+    const size_t end = (chunk + 1) * job.n / job.num_chunks;
+    std::exception_ptr failure;
+    try {
+        job.task(job.context, begin, end);
+    } catch (...) {
+        failure = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failure && !job.failure) {
+        job.failure = failure;
+    }
+    if (--job.pending_chunks == 0) {
+        work_done.notify_one();
+    }
+    return true;
+}
+
+void ThreadPool::run(size_t n, size_t num_chunks, Task task, void* context) {
+    std::unique_lock<std::mutex> submit(submit_mutex, std::try_to_lock);
+    if (!submit.owns_lock()) {
+        // Another thread is using the pool: do the work here rather than wait
+        task(context, 0, n);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = Job{task, context, n, num_chunks, 0, num_chunks, nullptr};
+        ++generation;
+    }
+    work_ready.notify_all();
+
+    in_parallel_region() = true;
+    while (run_chunk()) {
+    }
+    in_parallel_region() = false;
+
+    std::exception_ptr failure;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&] { return job.pending_chunks == 0; });
+        job.task = nullptr;
+        failure = job.failure;
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
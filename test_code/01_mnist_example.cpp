@@ -4,7 +4,7 @@
 
 
 
-// g++ -std=c++17 -I. test_code/01_mnist_example.cpp src/matrix/matrix.cpp src/utils/file_io.cpp -o mnist_test && ./mnist_test
+// g++ -std=c++17 -I. test_code/01_mnist_example.cpp src/matrix/matrix.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/file_io.cpp -o mnist_test && ./mnist_test
 
 int main() {
     try {
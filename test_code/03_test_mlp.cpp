@@ -2,7 +2,7 @@
 #include "../include/matrix/matrix.h"
 #include <iostream>
 /*
-g++ -std=c++17 -I. test_code/03_test_mlp.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/activation_functions.h.cpp src/transformer/mlp.cpp -o test_mlp && ./test_mlp
+g++ -std=c++17 -I. test_code/03_test_mlp.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/mlp.cpp -pthread -o test_mlp && ./test_mlp
 
  */
 int main() {
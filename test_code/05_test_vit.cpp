@@ -4,7 +4,7 @@
 #include <iostream>
 
 /*
-g++ -std=c++17 -I. test_code/05_test_vit.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -o test_vit && ./test_vit
+g++ -std=c++17 -I. test_code/05_test_vit.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_vit && ./test_vit
 
  */
 int main() {
@@ -0,0 +1,305 @@
+#include "../include/matrix/matrix.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/gemm.h"
+#include "../include/matrix/kernels.h"
+#include "../include/matrix/packed_weight.h"
+#include "../include/matrix/activation_functions.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/06_test_gemm.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp -pthread -o test_gemm && ./test_gemm
+*/
+
+static double max_abs_diff(const Matrix& a, const Matrix& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.getRows(); ++i) {
+        for (size_t j = 0; j < a.getCols(); ++j) {
+            diff = std::max(diff, std::abs(a(i, j) - b(i, j)));
+        }
+    }
+    return diff;
+}
+
+int main() {
+    try {
+        std::cout << "Testing blocked GEMM..." << std::endl;
+
+        // ViT shapes (M, K, N) plus odd sizes that exercise the edge tiles
+        const size_t shapes[][3] = {
+            {50, 256, 256}, {50, 256, 1024}, {50, 1024, 256}, {50, 32, 50},
+            {50, 50, 32}, {1, 256, 10}, {49, 16, 256}, {97, 301, 263}, {3, 5, 7}
+        };
+
+        bool ok = true;
+        for (const auto& shape : shapes) {
+            Matrix a = Matrix::random(shape[0], shape[1], -1.0, 1.0);
+            Matrix b = Matrix::random(shape[1], shape[2], -1.0, 1.0);
+
+            Matrix expected = MatrixOps::matmul_reference(a, b);
+
+            const int reps = 20;
+            auto start = std::chrono::steady_clock::now();
+            Matrix result;
+            for (int r = 0; r < reps; ++r) {
+                result = MatrixOps::matmul(a, b);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double us = std::chrono::duration<double, std::micro>(end - start).count() / reps;
+            double gflops = 2.0 * shape[0] * shape[1] * shape[2] / (us * 1e3);
+
+            double diff = max_abs_diff(result, expected);
+            bool pass = diff < 1e-9 * shape[1];
+            ok = ok && pass;
+            std::cout << (pass ? "✅ " : "❌ ") << shape[0] << "x" << shape[1] << " * "
+                      << shape[1] << "x" << shape[2] << ": max diff " << diff
+                      << ", " << us << " us, " << gflops << " GFLOP/s" << std::endl;
+        }
+
+        // Strided operands and output (head slices of a wider matrix)
+        Matrix wide = Matrix::random(50, 256, -1.0, 1.0);
+        Matrix rhs = Matrix::random(32, 40, -1.0, 1.0);
+        Matrix out = Matrix::zeros(50, 256);
+        Gemm::gemm(wide.block(0, 64, 50, 32), rhs, out.block(0, 96, 50, 40));
+        Matrix expected = MatrixOps::matmul_reference(Matrix(wide.block(0, 64, 50, 32)), rhs);
+        double diff = max_abs_diff(Matrix(out.block(0, 96, 50, 40)), expected);
+        bool pass = diff < 1e-9 && out(0, 95) == 0.0 && out(0, 136) == 0.0;
+        ok = ok && pass;
+        std::cout << (pass ? "✅ " : "❌ ") << "Strided views: max diff " << diff << std::endl;
+
+        // Transposed operands read in place, including strided head slices
+        for (const auto& shape : shapes) {
+            Matrix a = Matrix::random(shape[0], shape[1], -1.0, 1.0);
+            Matrix b_t = Matrix::random(shape[2], shape[1], -1.0, 1.0);
+            Matrix a_t = MatrixOps::transpose(a);
+            Matrix expected = MatrixOps::matmul_reference(a, MatrixOps::transpose(b_t));
+
+            double diff = std::max(max_abs_diff(MatrixOps::matmul_nt(a, b_t), expected),
+                                   max_abs_diff(MatrixOps::matmul_tn(a_t, MatrixOps::transpose(b_t)), expected));
+            bool pass = diff < 1e-9 * shape[1];
+            ok = ok && pass;
+            std::cout << (pass ? "✅ " : "❌ ") << "NT/TN " << shape[0] << "x" << shape[1] << "x"
+                      << shape[2] << ": max diff " << diff << std::endl;
+        }
+        Matrix keys = Matrix::random(50, 256, -1.0, 1.0);
+        Matrix scores(50, 50);
+        MatrixOps::matmul_nt_into(wide.block(0, 64, 50, 32), keys.block(0, 64, 50, 32), scores);
+        expected = MatrixOps::matmul_reference(Matrix(wide.block(0, 64, 50, 32)),
+                                               MatrixOps::transpose(keys.block(0, 64, 50, 32)));
+        diff = max_abs_diff(scores, expected);
+        pass = diff < 1e-9;
+        ok = ok && pass;
+        std::cout << (pass ? "✅ " : "❌ ") << "Strided Q * K^T: max diff " << diff << std::endl;
+
+        // Attention-score shape: explicit transpose + matmul against reading K in place
+        const int reps = 2000;
+        Matrix q = Matrix::random(50, 32, -1.0, 1.0);
+        Matrix k = Matrix::random(50, 32, -1.0, 1.0);
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            MatrixOps::matmul_into(q, MatrixOps::transpose(k), scores);
+        }
+        auto mid = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            MatrixOps::matmul_nt_into(q, k, scores);
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "Q * K^T (50x32): transpose + matmul "
+                  << std::chrono::duration<double, std::micro>(mid - start).count() / reps << " us, matmul_nt "
+                  << std::chrono::duration<double, std::micro>(end - mid).count() / reps << " us" << std::endl;
+
+        // Batched products over the 8 heads of a 50x256 projection: Q_h * K_h^T
+        // into stacked score blocks, then scores_h * V_h back into head columns
+        const size_t heads = 8, seq = 50, head_dim = 32;
+        Matrix proj_q = Matrix::random(seq, heads * head_dim, -1.0, 1.0);
+        Matrix proj_k = Matrix::random(seq, heads * head_dim, -1.0, 1.0);
+        Matrix stacked(heads * seq, seq);
+        Matrix context(seq, heads * head_dim);
+        MatrixOps::matmul_batched_into(heads, proj_q.block(0, 0, seq, head_dim), head_dim,
+                                       proj_k.block(0, 0, seq, head_dim), head_dim,
+                                       stacked.block(0, 0, seq, seq), seq * seq, false, true);
+        MatrixOps::matmul_batched_into(heads, stacked.block(0, 0, seq, seq), seq * seq,
+                                       proj_k.block(0, 0, seq, head_dim), head_dim,
+                                       context.block(0, 0, seq, head_dim), head_dim);
+        diff = 0.0;
+        for (size_t h = 0; h < heads; ++h) {
+            Matrix q_h(proj_q.block(0, h * head_dim, seq, head_dim));
+            Matrix k_h(proj_k.block(0, h * head_dim, seq, head_dim));
+            Matrix s_h = MatrixOps::matmul_reference(q_h, MatrixOps::transpose(k_h));
+            diff = std::max(diff, max_abs_diff(Matrix(stacked.block(h * seq, 0, seq, seq)), s_h));
+            diff = std::max(diff, max_abs_diff(Matrix(context.block(0, h * head_dim, seq, head_dim)),
+                                               MatrixOps::matmul_reference(s_h, k_h)));
+        }
+        // a^T * b over stacked items
+        Matrix stacked_a = Matrix::random(3 * 40, 30, -1.0, 1.0);
+        Matrix stacked_b = Matrix::random(3 * 40, 20, -1.0, 1.0);
+        Matrix stacked_c(3 * 30, 20);
+        MatrixOps::matmul_batched_into(3, stacked_a.block(0, 0, 40, 30), 40 * 30, stacked_b.block(0, 0, 40, 20),
+                                       40 * 20, stacked_c.block(0, 0, 30, 20), 30 * 20, true, false);
+        for (size_t i = 0; i < 3; ++i) {
+            Matrix expected_c = MatrixOps::matmul_reference(
+                MatrixOps::transpose(stacked_a.block(i * 40, 0, 40, 30)), Matrix(stacked_b.block(i * 40, 0, 40, 20)));
+            diff = std::max(diff, max_abs_diff(Matrix(stacked_c.block(i * 30, 0, 30, 20)), expected_c));
+        }
+        pass = diff < 1e-9 * seq;
+        ok = ok && pass;
+        std::cout << (pass ? "✅ " : "❌ ") << "Batched GEMM: max diff " << diff << std::endl;
+
+        // A ninth head runs past the projection's rows, and output items one
+        // column apart overlap: both are rejected before any item runs
+        size_t rejected = 0;
+        try {
+            MatrixOps::matmul_batched_into(heads + 1, proj_q.block(0, 0, seq, head_dim), head_dim,
+                                           proj_k.block(0, 0, seq, head_dim), head_dim,
+                                           stacked.block(0, 0, seq, seq), seq * seq, false, true);
+        } catch (const std::invalid_argument&) {
+            ++rejected;
+        }
+        try {
+            MatrixOps::matmul_batched_into(heads, stacked.block(0, 0, seq, seq), seq * seq,
+                                           proj_k.block(0, 0, seq, head_dim), head_dim,
+                                           context.block(0, 0, seq, head_dim), head_dim / 2);
+        } catch (const std::invalid_argument&) {
+            ++rejected;
+        }
+        pass = rejected == 2;
+        ok = ok && pass;
+        std::cout << (pass ? "✅ " : "❌ ") << "Batched GEMM rejects out-of-row and overlapping items" << std::endl;
+
+        const int head_reps = 500;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < head_reps; ++r) {
+            for (size_t h = 0; h < heads; ++h) {
+                MatrixOps::matmul_nt_into(proj_q.block(0, h * head_dim, seq, head_dim),
+                                          proj_k.block(0, h * head_dim, seq, head_dim),
+                                          stacked.block(h * seq, 0, seq, seq));
+            }
+        }
+        mid = std::chrono::steady_clock::now();
+        for (int r = 0; r < head_reps; ++r) {
+            MatrixOps::matmul_batched_into(heads, proj_q.block(0, 0, seq, head_dim), head_dim,
+                                           proj_k.block(0, 0, seq, head_dim), head_dim,
+                                           stacked.block(0, 0, seq, seq), seq * seq, false, true);
+        }
+        end = std::chrono::steady_clock::now();
+        std::cout << "8 heads of Q * K^T (50x32): per-head loop "
+                  << std::chrono::duration<double, std::micro>(mid - start).count() / head_reps << " us, batched "
+                  << std::chrono::duration<double, std::micro>(end - mid).count() / head_reps << " us" << std::endl;
+
+        // Fused bias + activation epilogue against the separate passes
+        using MatrixOps::Activation;
+        for (const auto& shape : shapes) {
+            Matrix x = Matrix::random(shape[0], shape[1], -1.0, 1.0);
+            Matrix w = Matrix::random(shape[1], shape[2], -1.0, 1.0);
+            Matrix bias = Matrix::random(1, shape[2], -1.0, 1.0);
+            Matrix pre = MatrixOps::addBroadcast(MatrixOps::matmul(x, w), bias);
+
+            double diff = max_abs_diff(MatrixOps::linear(x, w, bias), pre);
+            diff = std::max(diff, max_abs_diff(MatrixOps::linear(x, w, bias, Activation::ReLU),
+                                               ActivationFunctions::relu(pre)));
+            diff = std::max(diff, max_abs_diff(MatrixOps::linear(x, w, bias, Activation::GELU),
+                                               ActivationFunctions::gelu(pre)));
+            Matrix nt(shape[0], shape[2]);
+            MatrixOps::linear_nt_into(x, MatrixOps::transpose(w), bias, nt, Activation::GELU);
+            diff = std::max(diff, max_abs_diff(nt, ActivationFunctions::gelu(pre)));
+
+            bool pass = diff < 1e-9 * shape[1];
+            ok = ok && pass;
+            std::cout << (pass ? "✅ " : "❌ ") << "Linear " << shape[0] << "x" << shape[1] << "x"
+                      << shape[2] << ": max diff " << diff << std::endl;
+        }
+
+        // Weights packed ahead of time, read plain or stored transposed; the
+        // last shape spans more than one nc column block
+        const size_t packed_shapes[][3] = {{50, 256, 1024}, {50, 1024, 256}, {1, 256, 10}, {97, 301, 263},
+                                           {3, 5, 7}, {7, 300, 2100}};
+        for (const auto& shape : packed_shapes) {
+            Matrix x = Matrix::random(shape[0], shape[1], -1.0, 1.0);
+            Matrix w = Matrix::random(shape[1], shape[2], -1.0, 1.0);
+            Matrix bias = Matrix::random(1, shape[2], -1.0, 1.0);
+            Matrix expected = MatrixOps::linear(x, w, bias, Activation::GELU);
+
+            PackedWeight packed(w);
+            PackedWeight packed_t(MatrixOps::transpose(w), true);
+            Matrix out(shape[0], shape[2]);
+            MatrixOps::linear_into(x, packed, bias, out, Activation::GELU);
+            double diff = max_abs_diff(out, expected);
+            MatrixOps::linear_into(x, packed_t, bias, out, Activation::GELU);
+            diff = std::max(diff, max_abs_diff(out, expected));
+            MatrixOps::matmul_into(x, packed, out);
+            diff = std::max(diff, max_abs_diff(out, MatrixOps::matmul(x, w)));
+            diff = std::max(diff, max_abs_diff(packed_t.unpack(), w));
+
+            // Packed for another micro-kernel tile: falls back to the plain path
+            const Kernels::Isa isa = Kernels::active_set().isa;
+            if (isa != Kernels::Isa::Scalar && Kernels::set_isa(Kernels::Isa::Scalar)) {
+                MatrixOps::linear_into(x, packed, bias, out, Activation::GELU);
+                diff = std::max(diff, max_abs_diff(out, expected));
+                Kernels::set_isa(isa);
+            }
+
+            bool pass = diff < 1e-9 * shape[1];
+            ok = ok && pass;
+            std::cout << (pass ? "✅ " : "❌ ") << "Packed weight " << shape[0] << "x" << shape[1] << "x"
+                      << shape[2] << ": max diff " << diff << std::endl;
+        }
+
+        // MLP first layer (50x256 -> 50x1024): three passes against one
+        Matrix x = Matrix::random(50, 256, -1.0, 1.0);
+        Matrix w1 = Matrix::random(256, 1024, -1.0, 1.0);
+        Matrix b1 = Matrix::random(1, 1024, -1.0, 1.0);
+        Matrix hidden(50, 1024);
+        const int mlp_reps = 200;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < mlp_reps; ++r) {
+            MatrixOps::matmul_into(x, w1, hidden);
+            MatrixOps::addBroadcast_inplace(hidden, b1);
+            ActivationFunctions::gelu_inplace<double>(hidden);
+        }
+        mid = std::chrono::steady_clock::now();
+        for (int r = 0; r < mlp_reps; ++r) {
+            MatrixOps::linear_into(x, w1, b1, hidden, Activation::GELU);
+        }
+        end = std::chrono::steady_clock::now();
+        PackedWeight w1_packed(w1);
+        for (int r = 0; r < mlp_reps; ++r) {
+            MatrixOps::linear_into(x, w1_packed, b1, hidden, Activation::GELU);
+        }
+        auto packed_end = std::chrono::steady_clock::now();
+        std::cout << "Linear+bias+GELU (50x256x1024): separate passes "
+                  << std::chrono::duration<double, std::micro>(mid - start).count() / mlp_reps << " us, fused "
+                  << std::chrono::duration<double, std::micro>(end - mid).count() / mlp_reps << " us, prepacked "
+                  << std::chrono::duration<double, std::micro>(packed_end - end).count() / mlp_reps << " us"
+                  << std::endl;
+
+        // Projection without activation, where packing B is a larger share of the work
+        Matrix w_proj = Matrix::random(256, 256, -1.0, 1.0);
+        PackedWeight w_proj_packed(w_proj);
+        Matrix proj(50, 256);
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < mlp_reps; ++r) {
+            MatrixOps::matmul_into(x, w_proj, proj);
+        }
+        mid = std::chrono::steady_clock::now();
+        for (int r = 0; r < mlp_reps; ++r) {
+            MatrixOps::matmul_into(x, w_proj_packed, proj);
+        }
+        end = std::chrono::steady_clock::now();
+        std::cout << "Projection (50x256x256): packed per call "
+                  << std::chrono::duration<double, std::micro>(mid - start).count() / mlp_reps << " us, prepacked "
+                  << std::chrono::duration<double, std::micro>(end - mid).count() / mlp_reps << " us" << std::endl;
+
+        if (!ok) {
+            std::cerr << "GEMM mismatch against reference" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ GEMM matches reference!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include "../include/matrix/kernels.h"
+#include "../include/matrix/matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/07_test_kernels.cpp src/matrix/matrix.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp -o test_kernels && ./test_kernels
+*/
+
+template <typename T>
+static double max_rel_diff(const std::vector<T>& a, const std::vector<T>& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff = std::max(diff, std::abs(double(a[i]) - double(b[i])) / (1.0 + std::abs(double(b[i]))));
+    }
+    return diff;
+}
+
+// Runs every kernel of `table` against the scalar table on sizes that cover
+// full vectors and ragged tails
+template <typename T>
+static bool check_table(const Kernels::KernelTable<T>& table, const Kernels::KernelTable<T>& ref) {
+    const size_t sizes[] = {1, 3, 8, 17, 50, 256, 1024};
+    // Summation order differs between tables, so float only agrees to a few ulps
+    const double tol = sizeof(T) == sizeof(double) ? 1e-12 : 1e-5;
+    const char* precision = sizeof(T) == sizeof(double) ? "f64" : "f32";
+    bool ok = true;
+
+    for (size_t n : sizes) {
+        BasicMatrix<T> a = BasicMatrix<T>::random(1, n, T(-4), T(4));
+        BasicMatrix<T> b = BasicMatrix<T>::random(1, n, T(-4), T(4));
+        BasicMatrix<T> gamma = BasicMatrix<T>::random(1, n, T(0.5), T(1.5));
+        BasicMatrix<T> beta = BasicMatrix<T>::random(1, n, T(-0.5), T(0.5));
+        std::vector<T> out(n), expected(n);
+
+        auto report = [&](const char* name) {
+            double diff = max_rel_diff(out, expected);
+            if (diff > tol) {
+                std::cout << "❌ " << table.name << " " << precision << " " << name << " n=" << n
+                          << ": max rel diff " << diff << std::endl;
+                ok = false;
+            }
+        };
+
+        table.add(a.data(), b.data(), out.data(), n);
+        ref.add(a.data(), b.data(), expected.data(), n);
+        report("add");
+        table.sub(a.data(), b.data(), out.data(), n);
+        ref.sub(a.data(), b.data(), expected.data(), n);
+        report("sub");
+        table.mul(a.data(), b.data(), out.data(), n);
+        ref.mul(a.data(), b.data(), expected.data(), n);
+        report("mul");
+        table.scale(a.data(), T(0.37), out.data(), n);
+        ref.scale(a.data(), T(0.37), expected.data(), n);
+        report("scale");
+        table.add_scalar(a.data(), T(-1.5), out.data(), n);
+        ref.add_scalar(a.data(), T(-1.5), expected.data(), n);
+        report("add_scalar");
+        out.assign(1, table.sum(a.data(), n));
+        expected.assign(1, ref.sum(a.data(), n));
+        report("sum");
+        out.resize(n);
+        expected.resize(n);
+        table.exp(a.data(), out.data(), n);
+        ref.exp(a.data(), expected.data(), n);
+        report("exp");
+        table.tanh(a.data(), out.data(), n);
+        ref.tanh(a.data(), expected.data(), n);
+        report("tanh");
+        table.sigmoid(a.data(), out.data(), n);
+        ref.sigmoid(a.data(), expected.data(), n);
+        report("sigmoid");
+        table.softmax_row(a.data(), T(1), out.data(), n);
+        ref.softmax_row(a.data(), T(1), expected.data(), n);
+        report("softmax_row");
+        table.softmax_row(a.data(), T(-0.37), out.data(), n);
+        ref.softmax_row(a.data(), T(-0.37), expected.data(), n);
+        report("softmax_row scaled");
+        table.gelu(a.data(), out.data(), n);
+        ref.gelu(a.data(), expected.data(), n);
+        report("gelu");
+        table.layer_norm_row(a.data(), gamma.data(), beta.data(), T(1e-5), out.data(), n);
+        ref.layer_norm_row(a.data(), gamma.data(), beta.data(), T(1e-5), expected.data(), n);
+        report("layer_norm_row");
+
+        // Fused residual add: the normalized sum, and the sum itself written
+        // over a
+        std::vector<T> sum(a.data(), a.data() + n), sum_expected(n);
+        table.add_layer_norm_row(sum.data(), b.data(), gamma.data(), beta.data(), T(1e-5), sum.data(),
+                                 out.data(), n);
+        ref.add(a.data(), b.data(), sum_expected.data(), n);
+        ref.layer_norm_row(sum_expected.data(), gamma.data(), beta.data(), T(1e-5), expected.data(), n);
+        report("add_layer_norm_row");
+        out = sum;
+        expected = sum_expected;
+        report("add_layer_norm_row sum");
+    }
+
+    // One-pass statistics stay accurate on a row far from zero, where
+    // E[x^2] - E[x]^2 would cancel
+    for (size_t n : {7, 50, 256, 1000}) {
+        BasicMatrix<T> x = BasicMatrix<T>::random(1, n, T(999), T(1001));
+        BasicMatrix<T> gamma = BasicMatrix<T>::ones(1, n);
+        BasicMatrix<T> beta = BasicMatrix<T>::zeros(1, n);
+        std::vector<T> out(n), expected(n);
+        table.layer_norm_row(x.data(), gamma.data(), beta.data(), T(1e-5), out.data(), n);
+        double mean = 0.0, var = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            mean += x.data()[i];
+        }
+        mean /= n;
+        for (size_t i = 0; i < n; ++i) {
+            var += (x.data()[i] - mean) * (x.data()[i] - mean);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            expected[i] = T((x.data()[i] - mean) / std::sqrt(var / n + 1e-5));
+        }
+        if (max_rel_diff(out, expected) > (sizeof(T) == sizeof(double) ? 1e-10 : 1e-3)) {
+            std::cout << "❌ " << table.name << " " << precision << " layer_norm_row offset n=" << n << std::endl;
+            ok = false;
+        }
+    }
+
+    // Online softmax in place against a direct two-pass reference; a rising
+    // row raises the running max in every block
+    for (size_t n : {5, 64, 300, 20000}) {
+        for (bool rising : {false, true}) {
+            BasicMatrix<T> x = BasicMatrix<T>::random(1, n, T(-20), T(20));
+            if (rising) {
+                for (size_t i = 0; i < n; ++i) {
+                    x.data()[i] = T(-30) + T(60) * T(i) / T(n);
+                }
+            }
+            std::vector<T> out(x.data(), x.data() + n), expected(n);
+            const T scale = T(0.125);
+            table.softmax_row(out.data(), scale, out.data(), n);
+            double max_val = -INFINITY, sum = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                max_val = std::max(max_val, double(scale * x.data()[i]));
+            }
+            for (size_t i = 0; i < n; ++i) {
+                sum += std::exp(double(scale * x.data()[i]) - max_val);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                expected[i] = T(std::exp(double(scale * x.data()[i]) - max_val) / sum);
+            }
+            if (max_rel_diff(out, expected) > tol) {
+                std::cout << "❌ " << table.name << " " << precision << " softmax_row online n=" << n
+                          << (rising ? " rising" : "") << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    // Micro-kernel on a full and on an edge tile
+    const size_t mr = table.gemm_mr, nr = table.gemm_nr, kc = 37;
+    BasicMatrix<T> a_panel = BasicMatrix<T>::random(1, mr * kc, T(-1), T(1));
+    BasicMatrix<T> b_panel = BasicMatrix<T>::random(1, nr * kc, T(-1), T(1));
+    for (size_t m : {mr, mr - 1}) {
+        for (size_t n : {nr, nr - 3}) {
+            std::vector<T> out(mr * nr, T(1)), expected(mr * nr, T(1));
+            table.gemm_micro(kc, a_panel.data(), b_panel.data(), out.data(), nr, m, n, true);
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    for (size_t p = 0; p < kc; ++p) {
+                        expected[i * nr + j] += a_panel.data()[p * mr + i] * b_panel.data()[p * nr + j];
+                    }
+                }
+            }
+            if (max_rel_diff(out, expected) > tol) {
+                std::cout << "❌ " << table.name << " " << precision << " gemm_micro " << m << "x" << n << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+// Int8 GEMM must be exact: compare against the scalar kernel bit for bit
+static bool check_int8(const Kernels::KernelSet& set, const Kernels::KernelSet& ref) {
+    bool ok = true;
+    const size_t shapes[][3] = {{1, 1, 4}, {3, 5, 32}, {4, 9, 64}, {16, 7, 256}, {13, 33, 1032}};
+    for (const auto& shape : shapes) {
+        const size_t m = shape[0], n = shape[1], k = shape[2];
+        // b in the 16-column panel layout, padding columns included
+        const size_t padded_n = (n + 15) / 16 * 16;
+        std::vector<int8_t> a(m * k);
+        std::vector<int8_t, AlignedAllocator<int8_t, 64>> b(padded_n * k);
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = static_cast<int8_t>(int(i * 37 % 255) - 127);
+        }
+        for (size_t i = 0; i < b.size(); ++i) {
+            b[i] = static_cast<int8_t>(127 - int(i * 53 % 255));
+        }
+        std::vector<int32_t> sums(n, 0);
+        for (size_t j = 0; j < n; ++j) {
+            for (size_t p = 0; p < k; ++p) {
+                sums[j] += b[j / 16 * 16 * k + p / 4 * 64 + j % 16 * 4 + p % 4];
+            }
+        }
+        std::vector<int32_t> out(m * n), expected(m * n);
+        set.gemm_int8(a.data(), k, b.data(), sums.data(), out.data(), n, m, n, k);
+        ref.gemm_int8(a.data(), k, b.data(), sums.data(), expected.data(), n, m, n, k);
+        if (out != expected) {
+            std::cout << "❌ " << set.name << " gemm_int8 " << m << "x" << n << "x" << k << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// 16-bit weight widening: every bit pattern, bit for bit against scalar
+static bool check_widen(const Kernels::KernelSet& set, const Kernels::KernelSet& ref) {
+    std::vector<uint16_t> src(65536);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<uint16_t>(i);
+    }
+    std::vector<float> out(src.size()), expected(src.size());
+    bool ok = true;
+    set.bf16_to_float(src.data(), out.data(), src.size());
+    ref.bf16_to_float(src.data(), expected.data(), src.size());
+    if (std::memcmp(out.data(), expected.data(), out.size() * sizeof(float)) != 0) {
+        std::cout << "❌ " << set.name << " bf16_to_float" << std::endl;
+        ok = false;
+    }
+    set.fp16_to_float(src.data(), out.data(), src.size());
+    ref.fp16_to_float(src.data(), expected.data(), src.size());
+    if (std::memcmp(out.data(), expected.data(), out.size() * sizeof(float)) != 0) {
+        std::cout << "❌ " << set.name << " fp16_to_float" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+int main() {
+    try {
+        std::cout << "Testing SIMD kernels..." << std::endl;
+        std::cout << "Detected ISA: " << Kernels::isa_name(Kernels::detect_isa())
+                  << ", active: " << Kernels::active_set().name << std::endl;
+
+        bool ok = true;
+        for (Kernels::Isa isa : {Kernels::Isa::AVX2, Kernels::Isa::AVX512}) {
+            if (!Kernels::set_isa(isa)) {
+                std::cout << "⏭️  " << Kernels::isa_name(isa) << " not supported on this CPU" << std::endl;
+                continue;
+            }
+            const Kernels::KernelSet& ref = Kernels::scalar_kernels();
+            bool pass = check_table(Kernels::active<double>(), ref.f64) &&
+                        check_table(Kernels::active<float>(), ref.f32) &&
+                        check_table(Kernels::active_set().f64_exact, ref.f64_exact) &&
+                        check_table(Kernels::active_set().f32_exact, ref.f32_exact) &&
+                        check_int8(Kernels::active_set(), ref) &&
+                        check_widen(Kernels::active_set(), ref);
+            std::cout << (pass ? "✅ " : "❌ ") << Kernels::isa_name(isa) << " matches scalar" << std::endl;
+            ok = ok && pass;
+        }
+
+        if (!ok) {
+            return 1;
+        }
+        std::cout << "✅ Kernels working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
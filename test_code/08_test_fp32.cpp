@@ -0,0 +1,71 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/utils/file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/08_test_fp32.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_fp32 && ./test_fp32
+*/
+
+template <typename Model, typename M>
+static double time_forward(Model& model, const M& batch, M& logits) {
+    auto start = std::chrono::steady_clock::now();
+    logits = model.forward(batch);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static size_t argmax_row(const Matrix& m, size_t row) {
+    const double* p = m.row_ptr(row);
+    return std::max_element(p, p + m.getCols()) - p;
+}
+
+int main() {
+    try {
+        std::cout << "Testing float32 inference against the double reference..." << std::endl;
+
+        // Same weights in both precisions: the float model is converted from the double one
+        VisionTransformer vit(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit_f(vit);
+
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        const size_t batch_size = std::min<size_t>(32, images.getRows());
+        Matrix batch(images.block(0, 0, batch_size, images.getCols()));
+        MatrixF batch_f = batch.cast<float>();
+
+        Matrix logits;
+        MatrixF logits_f;
+        double ms = time_forward(vit, batch, logits);
+        double ms_f = time_forward(vit_f, batch_f, logits_f);
+
+        double max_diff = 0.0, max_logit = 0.0;
+        size_t agree = 0;
+        Matrix logits_fd = logits_f.cast<double>();
+        for (size_t i = 0; i < batch_size; ++i) {
+            for (size_t j = 0; j < logits.getCols(); ++j) {
+                max_diff = std::max(max_diff, std::abs(logits(i, j) - logits_fd(i, j)));
+                max_logit = std::max(max_logit, std::abs(logits(i, j)));
+            }
+            agree += argmax_row(logits, i) == argmax_row(logits_fd, i);
+        }
+
+        std::cout << "double: " << ms << " ms, float: " << ms_f << " ms ("
+                  << ms / ms_f << "x)" << std::endl;
+        std::cout << "Max logit diff: " << max_diff << " (max |logit| " << max_logit << ")" << std::endl;
+        std::cout << "Predictions agree on " << agree << "/" << batch_size << " images" << std::endl;
+
+        if (max_diff > 1e-3 * (1.0 + max_logit) || agree != batch_size) {
+            std::cout << "❌ float32 output diverges from double" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ float32 inference matches double!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
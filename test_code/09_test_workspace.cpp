@@ -0,0 +1,102 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/workspace.h"
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/09_test_workspace.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_workspace && ./test_workspace
+*/
+
+// Count every heap allocation made by the program
+static size_t heap_allocations = 0;
+
+void* operator new(size_t size) {
+    ++heap_allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    ++heap_allocations;
+    size_t alignment = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+static bool test_scopes() {
+    Workspace ws(1024);
+    MatrixView a = ws.alloc<double>(4, 4);
+    size_t after_a = ws.bytes_used();
+    bool tail_counted = false;
+    {
+        Workspace::Scope scope(ws);
+        ws.alloc<double>(100, 100);  // Overflows the first chunk, skipping its tail
+        ws.zeros<float>(3, 5);
+        tail_counted = ws.bytes_used() >= 1024 + 100 * 100 * sizeof(double);
+    }
+    bool ok = tail_counted && ws.bytes_used() == after_a && reinterpret_cast<uintptr_t>(a.data()) % 64 == 0;
+
+    // reset() merges the overflow chunks so the same pattern fits in one,
+    // with no tail to skip this time
+    ws.reset();
+    size_t chunks_before = ws.system_allocations();
+    ws.alloc<double>(4, 4);
+    ws.alloc<double>(100, 100);
+    ws.zeros<float>(3, 5);
+    ok = ok && ws.system_allocations() == chunks_before && ws.bytes_used() < ws.peak_bytes();
+    return ok;
+}
+
+int main() {
+    try {
+        std::cout << "Testing workspace allocator..." << std::endl;
+
+        if (!test_scopes()) {
+            std::cout << "❌ Workspace scopes or reset misbehave" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Scopes release, reset coalesces chunks" << std::endl;
+
+        VisionTransformer vit(28, 4, 256, 8, 6, 10);
+        Matrix images = Matrix::random(4, 28 * 28);
+        Matrix reference = vit.forward(images);
+
+        // Warm-up pass grows the workspace (and GEMM pack buffers) to their peak
+        Workspace ws;
+        Matrix logits(images.getRows(), 10);
+        vit.forward(images, logits, ws);
+        ws.reset();
+
+        size_t before = heap_allocations;
+        vit.forward(images, logits, ws);
+        ws.reset();
+        size_t steady = heap_allocations - before;
+
+        std::cout << "Workspace: " << ws.capacity() / 1024 << " KiB, peak "
+                  << ws.peak_bytes() / 1024 << " KiB, " << ws.system_allocations()
+                  << " system allocations" << std::endl;
+        std::cout << "Heap allocations in steady-state forward: " << steady << std::endl;
+
+        if (steady != 0 || logits != reference) {
+            std::cout << "❌ Steady-state forward allocates or changes the result" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Workspace forward is allocation-free!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
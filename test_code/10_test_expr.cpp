@@ -0,0 +1,105 @@
+#include "../include/matrix/matrix.h"
+#include "../include/matrix/matrix_ops.h"
+#include <chrono>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/10_test_expr.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp -pthread -o test_expr && ./test_expr
+*/
+
+template <typename F>
+static double time_us(F&& f, int reps) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / reps;
+}
+
+int main() {
+    try {
+        std::cout << "Testing lazy Matrix expressions..." << std::endl;
+        bool ok = true;
+
+        Matrix x = Matrix::random(50, 1024, -1.0, 1.0);
+        Matrix y = Matrix::random(50, 1024, -1.0, 1.0);
+        Matrix bias = Matrix::random(50, 1024, -1.0, 1.0);
+        const double scale = 0.125;
+
+        // Fused chain against the same steps done one operation at a time
+        Matrix fused = x * scale + y - bias / 2.0;
+        Matrix stepwise = MatrixOps::subtract(MatrixOps::add(MatrixOps::multiplyBroadcast(
+            x, Matrix(1, 1024, scale)), y), MatrixOps::multiplyBroadcast(bias, Matrix(1, 1024, 0.5)));
+        ok = ok && fused == stepwise;
+        std::cout << (fused == stepwise ? "✅" : "❌") << " Chain matches step-by-step result" << std::endl;
+
+        // Assigning into an operand is safe: every node is element-wise
+        Matrix acc = x;
+        acc = acc + y * 2.0;
+        Matrix expected = x + 2.0 * y;
+        ok = ok && acc == expected;
+        std::cout << (acc == expected ? "✅" : "❌") << " Self-assignment" << std::endl;
+
+        // Float matrices and scalars convert to the element type
+        MatrixF xf = x.cast<float>();
+        MatrixF half = xf * 0.5 + xf / 2;
+        ok = ok && half == xf;
+        std::cout << (half == xf ? "✅" : "❌") << " Float expressions" << std::endl;
+
+        // Mismatched shapes are rejected when the node is built
+        bool threw = false;
+        try {
+            Matrix bad = x + Matrix(2, 2);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        ok = ok && threw;
+        std::cout << (threw ? "✅" : "❌") << " Shape mismatch throws" << std::endl;
+
+        // Compound operators update the existing buffer
+        Matrix inplace = x;
+        const double* storage = inplace.data();
+        inplace += y;
+        inplace -= bias * 0.5;
+        inplace *= 4.0;
+        inplace /= 2.0;
+        Matrix compound = (x + y - bias * 0.5) * 2.0;
+        bool same_buffer = inplace.data() == storage && inplace == compound;
+        ok = ok && same_buffer;
+        std::cout << (same_buffer ? "✅" : "❌") << " Compound operators work in place" << std::endl;
+
+        // _inplace variants match their allocating counterparts
+        Matrix row_bias = Matrix::random(1, 1024, -1.0, 1.0);
+        Matrix biased = x;
+        MatrixOps::addBroadcast_inplace(biased, row_bias);
+        MatrixOps::add_inplace(biased, y);
+        MatrixOps::exp_inplace(biased);
+        Matrix reference = MatrixOps::exp(MatrixOps::add(MatrixOps::addBroadcast(x, row_bias), y));
+        ok = ok && biased == reference;
+        std::cout << (biased == reference ? "✅" : "❌") << " In-place MatrixOps" << std::endl;
+
+        // One pass instead of three for scale-then-add-then-bias
+        Matrix out(50, 1024);
+        const int reps = 200;
+        double t_fused = time_us([&] { out = x * scale + y + bias; }, reps);
+        double t_steps = time_us([&] {
+            Matrix scaled = x * scale;
+            Matrix added = scaled + y;
+            out = added + bias;
+        }, reps);
+        std::cout << "scale+add+bias on 50x1024: fused " << t_fused << " us, unfused "
+                  << t_steps << " us" << std::endl;
+
+        if (!ok) {
+            return 1;
+        }
+        std::cout << "✅ Expressions working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
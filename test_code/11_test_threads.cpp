@@ -0,0 +1,124 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/activation_functions.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/11_test_threads.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_threads && ./test_threads
+*/
+
+static double max_rel_diff(const Matrix& a, const Matrix& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.getRows(); ++i) {
+        for (size_t j = 0; j < a.getCols(); ++j) {
+            diff = std::max(diff, std::abs(a(i, j) - b(i, j)) / (1.0 + std::abs(b(i, j))));
+        }
+    }
+    return diff;
+}
+
+static bool test_pool(ThreadPool& pool) {
+    // Every index is visited exactly once
+    std::vector<std::atomic<int>> hits(10000);
+    pool.parallel_for(hits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            hits[i]++;
+        }
+    });
+    bool ok = std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; });
+
+    // Nested calls run inline instead of deadlocking
+    std::atomic<size_t> inner_total{0};
+    pool.parallel_for(64, 4096, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.parallel_for(1000, 4096, [&](size_t b, size_t e) { inner_total += e - b; });
+        }
+    });
+    ok = ok && inner_total == 64 * 1000;
+
+    // Exceptions reach the caller once every chunk has finished
+    bool threw = false;
+    try {
+        pool.parallel_for(1000, 4096, [](size_t begin, size_t) {
+            if (begin > 0) {
+                throw std::runtime_error("chunk failed");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    return ok && (threw || pool.getNumThreads() == 1);
+}
+
+int main() {
+    try {
+        std::cout << "Testing thread pool..." << std::endl;
+        ThreadPool& pool = ThreadPool::global();
+        const size_t default_threads = pool.getNumThreads();
+        std::cout << "Default threads: " << default_threads << std::endl;
+        bool ok = true;
+
+        // Baseline results on one thread
+        pool.set_num_threads(1);
+        Matrix a = Matrix::random(97, 301, -1.0, 1.0);
+        Matrix b = Matrix::random(301, 1030, -1.0, 1.0);
+        Matrix gemm_ref = MatrixOps::matmul(a, b);
+        Matrix gemm_nt_ref = MatrixOps::matmul_nt(b.block(0, 0, 301, 256), a.block(0, 0, 97, 256));
+        Matrix rows = Matrix::random(200, 1024, -3.0, 3.0);
+        Matrix gelu_ref = ActivationFunctions::gelu(rows);
+        Matrix softmax_ref = ActivationFunctions::softmax(rows);
+        Matrix gamma = Matrix::random(1, 1024), beta = Matrix::random(1, 1024);
+        Matrix norm_ref = ActivationFunctions::layerNorm(rows, gamma, beta);
+        Matrix bias_ref = MatrixOps::addBroadcast(rows, gamma);
+
+        VisionTransformer vit(28, 4, 256, 8, 6, 10);
+        Matrix images = Matrix::random(8, 28 * 28);
+        auto start = std::chrono::steady_clock::now();
+        Matrix logits_ref = vit.forward(images);
+        double ms_serial = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        for (size_t threads : {2, 3, 4, 8}) {
+            pool.set_num_threads(threads);
+            bool pool_ok = test_pool(pool);
+
+            double diff = max_rel_diff(MatrixOps::matmul(a, b), gemm_ref);
+            diff = std::max(diff, max_rel_diff(MatrixOps::matmul_nt(b.block(0, 0, 301, 256), a.block(0, 0, 97, 256)),
+                                               gemm_nt_ref));
+            diff = std::max(diff, max_rel_diff(ActivationFunctions::gelu(rows), gelu_ref));
+            diff = std::max(diff, max_rel_diff(ActivationFunctions::softmax(rows), softmax_ref));
+            diff = std::max(diff, max_rel_diff(ActivationFunctions::layerNorm(rows, gamma, beta), norm_ref));
+            diff = std::max(diff, max_rel_diff(MatrixOps::addBroadcast(rows, gamma), bias_ref));
+
+            start = std::chrono::steady_clock::now();
+            Matrix logits = vit.forward(images);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            diff = std::max(diff, max_rel_diff(logits, logits_ref));
+
+            bool pass = pool_ok && diff < 1e-12;
+            ok = ok && pass;
+            std::cout << (pass ? "✅ " : "❌ ") << threads << " threads: max rel diff " << diff
+                      << ", ViT forward " << ms << " ms (1 thread: " << ms_serial << " ms)" << std::endl;
+        }
+        pool.set_num_threads(default_threads);
+
+        if (!ok) {
+            std::cout << "❌ Threaded results differ from serial" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Thread pool working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
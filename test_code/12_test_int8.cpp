@@ -0,0 +1,145 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/kernels.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/quantized_weight.h"
+#include "../include/utils/file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/12_test_int8.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_int8 && ./test_int8
+*/
+
+template <typename M>
+static size_t argmax_row(const M& m, size_t row) {
+    const auto* p = m.row_ptr(row);
+    return std::max_element(p, p + m.getCols()) - p;
+}
+
+template <typename Model, typename M>
+static double time_forward(Model& model, const M& batch, M& logits) {
+    auto start = std::chrono::steady_clock::now();
+    logits = model.forward(batch);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Int8 linear layer against the float one on an MLP-sized product
+static bool test_linear_int8() {
+    MatrixF x = MatrixF::random(50, 256, -1.0f, 1.0f);
+    MatrixF w = MatrixF::random(256, 1024, -0.1f, 0.1f);
+    MatrixF bias = MatrixF::random(1, 1024, -0.5f, 0.5f);
+    MatrixF expected = MatrixOps::linear(x, w, bias, MatrixOps::Activation::GELU);
+
+    ActivationRange range;
+    range.observe(x);
+    QuantizedWeight w_int8(w);
+    QuantizedWeight w_int8_t(MatrixOps::transpose(w), true);
+    MatrixF out(50, 1024), out_t(50, 1024);
+    MatrixOps::linear_int8_into(x, range.getScale(), w_int8, bias, out, MatrixOps::Activation::GELU);
+    MatrixOps::linear_int8_into(x, range.getScale(), w_int8_t, bias, out_t, MatrixOps::Activation::GELU);
+
+    double max_diff = 0.0, max_out = 0.0, max_diff_t = 0.0;
+    for (size_t i = 0; i < out.getRows(); ++i) {
+        for (size_t j = 0; j < out.getCols(); ++j) {
+            max_diff = std::max(max_diff, double(std::abs(out(i, j) - expected(i, j))));
+            max_diff_t = std::max(max_diff_t, double(std::abs(out(i, j) - out_t(i, j))));
+            max_out = std::max(max_out, double(std::abs(expected(i, j))));
+        }
+    }
+    const bool pass = max_diff < 0.02 * max_out && max_diff_t == 0.0;
+    std::cout << (pass ? "✅ " : "❌ ") << "Int8 linear 50x256x1024: max diff " << max_diff
+              << " (max |out| " << max_out << "), weight " << w_int8.bytes() << " bytes vs "
+              << w.size() * sizeof(float) << " float" << std::endl;
+
+    // Projection without activation, so the GEMM itself dominates
+    const int reps = 200;
+    PackedWeightF w_packed(w);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        MatrixOps::linear_into(x, w_packed, bias, out);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        MatrixOps::linear_int8_into(x, range.getScale(), w_int8, bias, out);
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Linear 50x256x1024 (" << Kernels::active_set().name << "): float "
+              << std::chrono::duration<double, std::micro>(mid - start).count() / reps << " us, int8 "
+              << std::chrono::duration<double, std::micro>(end - mid).count() / reps << " us" << std::endl;
+    return pass;
+}
+
+int main() {
+    try {
+        std::cout << "Testing int8 post-training quantization..." << std::endl;
+        bool ok = test_linear_int8();
+
+        // fp64 reference, a float copy, and a float copy quantized to int8
+        VisionTransformer vit(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit_f(vit);
+        VisionTransformerF vit_int8(vit);
+
+        // Calibrate on a sample of the training set
+        const size_t calibration_size = 256;
+        Matrix train = FileIO::load_mnist_images("data/train-images-idx3-ubyte/train-images-idx3-ubyte");
+        MatrixF calibration = Matrix(train.block(0, 0, std::min(calibration_size, train.getRows()),
+                                                 train.getCols())).cast<float>();
+        auto start = std::chrono::steady_clock::now();
+        vit_int8.quantize(calibration);
+        double ms_calibrate = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Calibrated on " << calibration.getRows() << " training images in " << ms_calibrate << " ms"
+                  << std::endl;
+        std::cout << "Linear weights: fp64 " << vit.getLinearWeightBytes() / 1024 << " KiB, fp32 "
+                  << vit_f.getLinearWeightBytes() / 1024 << " KiB, int8 "
+                  << vit_int8.getLinearWeightBytes() / 1024 << " KiB" << std::endl;
+
+        // Evaluate on the start of t10k
+        const size_t test_size = 500;
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        std::vector<int> labels = FileIO::load_mnist_labels("data/t10k-labels-idx1-ubyte/t10k-labels-idx1-ubyte");
+        const size_t n = std::min(test_size, images.getRows());
+        Matrix batch(images.block(0, 0, n, images.getCols()));
+        MatrixF batch_f = batch.cast<float>();
+
+        Matrix logits;
+        MatrixF logits_f, logits_int8;
+        double ms = time_forward(vit, batch, logits);
+        double ms_f = time_forward(vit_f, batch_f, logits_f);
+        double ms_int8 = time_forward(vit_int8, batch_f, logits_int8);
+
+        size_t correct = 0, correct_int8 = 0, agree = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t reference = argmax_row(logits, i);
+            const size_t quantized = argmax_row(logits_int8, i);
+            correct += reference == static_cast<size_t>(labels[i]);
+            correct_int8 += quantized == static_cast<size_t>(labels[i]);
+            agree += reference == quantized;
+        }
+        const double accuracy = 100.0 * correct / n;
+        const double accuracy_int8 = 100.0 * correct_int8 / n;
+
+        std::cout << n << " t10k images: fp64 " << ms << " ms, fp32 " << ms_f << " ms, int8 " << ms_int8
+                  << " ms (" << ms_f / ms_int8 << "x over fp32)" << std::endl;
+        std::cout << "Accuracy: fp64 " << accuracy << "%, int8 " << accuracy_int8 << "% (delta "
+                  << accuracy_int8 - accuracy << " points)" << std::endl;
+        std::cout << "int8 top-1 agrees with fp64 on " << agree << "/" << n << " images" << std::endl;
+
+        const bool pass = agree >= n * 9 / 10 && vit_int8.getLinearWeightBytes() * 3 < vit_f.getLinearWeightBytes();
+        ok = ok && pass;
+        if (!ok) {
+            std::cout << "❌ Int8 model diverges from fp64" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Int8 quantization working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
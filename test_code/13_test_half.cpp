@@ -0,0 +1,181 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/half.h"
+#include "../include/matrix/kernels.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/utils/file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/13_test_half.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_half && ./test_half
+*/
+
+template <typename M>
+static size_t argmax_row(const M& m, size_t row) {
+    const auto* p = m.row_ptr(row);
+    return std::max_element(p, p + m.getCols()) - p;
+}
+
+// Every finite 16-bit value converts to float and back unchanged, and a few
+// rounding cases land where IEEE round-to-nearest-even puts them
+static bool test_conversions() {
+    bool ok = true;
+    for (uint32_t h = 0; h < 65536; ++h) {
+        const uint16_t bits = static_cast<uint16_t>(h);
+        if ((h & 0x7fffu) < 0x7f80u && float_to_bf16(bf16_to_float(bits)) != bits) {
+            ok = false;
+        }
+        if ((h & 0x7fffu) <= 0x7c00u && float_to_fp16(fp16_to_float(bits)) != bits) {
+            ok = false;
+        }
+    }
+    ok = ok && float_to_fp16(1.0f + std::ldexp(1.0f, -11)) == 0x3c00;  // Tie to even: 1
+    ok = ok && float_to_fp16(65504.0f) == 0x7bff && float_to_fp16(65520.0f) == 0x7c00;
+    ok = ok && float_to_fp16(std::ldexp(3.0f, -25)) == 0x0002;  // Subnormal tie to even
+    ok = ok && float_to_fp16(std::ldexp(1.0f, -26)) == 0x0000;
+    ok = ok && std::isnan(fp16_to_float(float_to_fp16(NAN))) && std::isnan(bf16_to_float(float_to_bf16(NAN)));
+    ok = ok && float_to_bf16(1.0f + std::ldexp(1.0f, -8)) == 0x3f80;  // Tie to even: 1
+    std::cout << (ok ? "✅ " : "❌ ") << "bf16 / fp16 conversions round trip and round to nearest even"
+              << std::endl;
+    return ok;
+}
+
+// Linear layer with 16-bit weights against the float one on an MLP-sized product
+static bool test_linear(WeightStorage storage, double tolerance) {
+    MatrixF x = MatrixF::random(50, 256, -1.0f, 1.0f);
+    MatrixF w = MatrixF::random(256, 1024, -0.1f, 0.1f);
+    MatrixF bias = MatrixF::random(1, 1024, -0.5f, 0.5f);
+    PackedWeightF w_packed(w);
+    PackedWeightF w_half(w, false, storage);
+    MatrixF expected(50, 1024), out(50, 1024);
+    MatrixOps::linear_into(x, w_packed, bias, expected, MatrixOps::Activation::GELU);
+    MatrixOps::linear_into(x, w_half, bias, out, MatrixOps::Activation::GELU);
+
+    double max_diff = 0.0, max_out = 0.0;
+    for (size_t i = 0; i < out.getRows(); ++i) {
+        for (size_t j = 0; j < out.getCols(); ++j) {
+            max_diff = std::max(max_diff, double(std::abs(out(i, j) - expected(i, j))));
+            max_out = std::max(max_out, double(std::abs(expected(i, j))));
+        }
+    }
+
+    // The weights themselves must come back as their rounded values
+    const MatrixF unpacked = w_half.unpack();
+    bool exact = true;
+    for (size_t p = 0; p < w.getRows(); ++p) {
+        for (size_t j = 0; j < w.getCols(); ++j) {
+            const float rounded = storage == WeightStorage::BF16 ? bf16_to_float(float_to_bf16(w(p, j)))
+                                                                 : fp16_to_float(float_to_fp16(w(p, j)));
+            exact = exact && unpacked(p, j) == rounded;
+        }
+    }
+
+    const bool pass = max_diff < tolerance * max_out && exact && w_half.bytes() * 2 == w_packed.bytes();
+    std::cout << (pass ? "✅ " : "❌ ") << weight_storage_name(storage) << " linear 50x256x1024: max diff "
+              << max_diff << " (max |out| " << max_out << "), weight " << w_half.bytes() << " bytes vs "
+              << w_packed.bytes() << " float" << std::endl;
+
+    const int reps = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        MatrixOps::linear_into(x, w_packed, bias, out);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        MatrixOps::linear_into(x, w_half, bias, out);
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Linear 50x256x1024 (" << Kernels::active_set().name << "): float "
+              << std::chrono::duration<double, std::micro>(mid - start).count() / reps << " us, "
+              << weight_storage_name(storage) << " "
+              << std::chrono::duration<double, std::micro>(end - mid).count() / reps << " us" << std::endl;
+    return pass;
+}
+
+template <typename Model, typename M>
+static double time_forward(Model& model, const M& batch, M& logits) {
+    auto start = std::chrono::steady_clock::now();
+    logits = model.forward(batch);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    try {
+        std::cout << "Testing bf16 / fp16 weight storage..." << std::endl;
+        bool ok = test_conversions();
+        ok = test_linear(WeightStorage::BF16, 0.02) && ok;
+        ok = test_linear(WeightStorage::FP16, 0.002) && ok;
+
+        // fp64 reference, fp32, and 16-bit copies in both precisions
+        VisionTransformer vit(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit_f(vit);
+        VisionTransformerF vit_bf16(vit);
+        vit_bf16.set_weight_storage(WeightStorage::BF16);
+        VisionTransformerF vit_fp16(vit);
+        vit_fp16.set_weight_storage(WeightStorage::FP16);
+        VisionTransformer vit_d_bf16(vit_f);  // Through float, which bf16 rounding swamps
+        vit_d_bf16.set_weight_storage(WeightStorage::BF16);
+
+        std::cout << "Linear weights: fp64 " << vit.getLinearWeightBytes() / 1024 << " KiB, fp32 "
+                  << vit_f.getLinearWeightBytes() / 1024 << " KiB, bf16 " << vit_bf16.getLinearWeightBytes() / 1024
+                  << " KiB, fp16 " << vit_fp16.getLinearWeightBytes() / 1024 << " KiB" << std::endl;
+        ok = ok && vit_bf16.getLinearWeightBytes() * 2 == vit_f.getLinearWeightBytes() &&
+             vit_d_bf16.getLinearWeightBytes() * 4 == vit.getLinearWeightBytes();
+
+        // A model built with 16-bit storage, and a float copy of a 16-bit model
+        VisionTransformerF vit_built(28, 4, 256, 8, 6, 10, WeightStorage::FP16);
+        VisionTransformerF vit_copy(vit_d_bf16);
+        ok = ok && vit_built.getWeightStorage() == WeightStorage::FP16 &&
+             vit_copy.getWeightStorage() == WeightStorage::BF16;
+
+        const size_t test_size = 500;
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        const size_t n = std::min(test_size, images.getRows());
+        Matrix batch(images.block(0, 0, n, images.getCols()));
+        MatrixF batch_f = batch.cast<float>();
+
+        Matrix logits, logits_d_bf16;
+        MatrixF logits_f, logits_bf16, logits_fp16, logits_copy;
+        const double ms = time_forward(vit, batch, logits);
+        const double ms_f = time_forward(vit_f, batch_f, logits_f);
+        const double ms_bf16 = time_forward(vit_bf16, batch_f, logits_bf16);
+        const double ms_fp16 = time_forward(vit_fp16, batch_f, logits_fp16);
+        const double ms_d_bf16 = time_forward(vit_d_bf16, batch, logits_d_bf16);
+        time_forward(vit_copy, batch_f, logits_copy);
+        std::cout << n << " t10k images: fp64 " << ms << " ms, fp32 " << ms_f << " ms, bf16 " << ms_bf16
+                  << " ms, fp16 " << ms_fp16 << " ms, fp64 with bf16 weights " << ms_d_bf16 << " ms" << std::endl;
+
+        size_t agree_bf16 = 0, agree_fp16 = 0, agree_d_bf16 = 0;
+        double max_diff_copy = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t reference = argmax_row(logits, i);
+            agree_bf16 += argmax_row(logits_bf16, i) == reference;
+            agree_fp16 += argmax_row(logits_fp16, i) == reference;
+            agree_d_bf16 += argmax_row(logits_d_bf16, i) == reference;
+            for (size_t j = 0; j < logits.getCols(); ++j) {
+                max_diff_copy = std::max(max_diff_copy, double(std::abs(logits_copy(i, j) - logits_bf16(i, j))));
+            }
+        }
+        std::cout << "Top-1 agreement with fp64: bf16 " << agree_bf16 << "/" << n << ", fp16 " << agree_fp16 << "/"
+                  << n << ", fp64 with bf16 weights " << agree_d_bf16 << "/" << n << std::endl;
+
+        // The float copy of the double bf16 model holds the same rounded weights
+        ok = ok && agree_bf16 >= n * 95 / 100 && agree_fp16 >= n * 99 / 100 && agree_d_bf16 >= n * 95 / 100 &&
+             max_diff_copy < 1e-3;
+        if (!ok) {
+            std::cout << "❌ 16-bit weight storage diverges" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ bf16 / fp16 weight storage working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/gemm_tuning.h"
+#include "../include/matrix/matrix_ops.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/14_test_autotune.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_autotune && ./test_autotune
+*/
+
+template <typename M>
+static double max_abs_diff(const M& a, const M& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.getRows(); ++i) {
+        for (size_t j = 0; j < a.getCols(); ++j) {
+            diff = std::max(diff, double(std::abs(a(i, j) - b(i, j))));
+        }
+    }
+    return diff;
+}
+
+template <typename M>
+static double max_abs(const M& a) {
+    double value = 0.0;
+    for (size_t i = 0; i < a.getRows(); ++i) {
+        for (size_t j = 0; j < a.getCols(); ++j) {
+            value = std::max(value, double(std::abs(a(i, j))));
+        }
+    }
+    return value;
+}
+
+static double time_forward(VisionTransformerF& model, const MatrixF& batch, MatrixF& logits) {
+    auto start = std::chrono::steady_clock::now();
+    logits = model.forward(batch);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    try {
+        std::cout << "Testing GEMM autotuning..." << std::endl;
+        std::cout << "Host: " << Gemm::tuning_host_key() << std::endl;
+        Gemm::clear_tuning();
+
+        // Untuned model and a reference product
+        VisionTransformer reference(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit_default(reference);
+        MatrixF a = MatrixF::random(50, 1024);
+        MatrixF b = MatrixF::random(1024, 256);
+        MatrixF expected = MatrixOps::matmul(a, b);
+
+        const auto results = Gemm::autotune();
+        for (const Gemm::TuneResult& r : results) {
+            const Gemm::BlockSizes& bs = r.config.blocks;
+            std::cout << "  " << (r.element_size == sizeof(float) ? "f32 " : "f64 ") << r.shape.m << "x"
+                      << r.shape.n << "x" << r.shape.k << (r.shape.packed_b ? " packed" : "")
+                      << (r.shape.trans_b ? " nt" : "") << ": mc " << bs.mc
+                      << " kc " << bs.kc << " nc " << bs.nc << " threads " << r.config.threads << ", "
+                      << r.default_us << " -> " << r.tuned_us << " us" << std::endl;
+        }
+        bool ok = results.size() == 2 * Gemm::vit_shapes().size() &&
+                  Gemm::tuned_shape_count() == results.size();
+
+        // Tuned configs give the same products
+        MatrixF tuned = MatrixOps::matmul(a, b);
+        const bool same_product = max_abs_diff(tuned, expected) < 1e-3;
+        std::cout << (same_product ? "✅ " : "❌ ") << "Tuned 50x1024 * 1024x256 matches untuned" << std::endl;
+        ok = ok && same_product;
+
+        // Round trip through the cache file, in the temp directory
+        const std::filesystem::path dir = std::filesystem::temp_directory_path();
+        const std::string path = (dir / "gemm_tuning_test.txt").string();
+        const std::string other_path = (dir / "gemm_tuning_other.txt").string();
+        const Gemm::GemmConfig before = Gemm::config_for(50, 1024, 256, sizeof(float));
+        bool cache_ok = Gemm::save_tuning(path);
+        Gemm::clear_tuning();
+        cache_ok = cache_ok && Gemm::tuned_shape_count() == 0 && Gemm::load_tuning(path) &&
+                   Gemm::tuned_shape_count() == results.size();
+        const Gemm::GemmConfig after = Gemm::config_for(50, 1024, 256, sizeof(float));
+        cache_ok = cache_ok && before.blocks.mc == after.blocks.mc && before.blocks.kc == after.blocks.kc &&
+                   before.blocks.nc == after.blocks.nc && before.threads == after.threads;
+
+        // A cache from another host is ignored
+        {
+            std::ofstream other(other_path);
+            other << "host Some Other CPU (avx2)\nshape 4 50 1024 256 1 24 64 256 1\n";
+        }
+        cache_ok = cache_ok && !Gemm::load_tuning(other_path) && Gemm::tuned_shape_count() == results.size() &&
+                   !Gemm::load_tuning((dir / "missing_tuning.txt").string());
+        std::remove(path.c_str());
+        std::remove(other_path.c_str());
+        std::cout << (cache_ok ? "✅ " : "❌ ") << "Tuning cache saves, reloads and rejects other hosts"
+                  << std::endl;
+        ok = ok && cache_ok;
+
+        // A model built now packs its weights for the tuned shapes
+        VisionTransformerF vit_tuned(reference);
+        MatrixF batch = MatrixF::random(100, 784, 0.0f, 1.0f);
+        MatrixF logits_default, logits_tuned;
+        time_forward(vit_default, batch, logits_default);
+        time_forward(vit_tuned, batch, logits_tuned);
+        const double ms_default = time_forward(vit_default, batch, logits_default);
+        const double ms_tuned = time_forward(vit_tuned, batch, logits_tuned);
+        // Tuned blockings change the order of f32 accumulation through every
+        // layer, so the logits agree relative to their size, not bitwise
+        const double diff = max_abs_diff(logits_default, logits_tuned);
+        const double scale = std::max(1.0, max_abs(logits_default));
+        std::cout << "100 images: default " << ms_default << " ms, tuned " << ms_tuned << " ms ("
+                  << ms_default / ms_tuned << "x), logits max diff " << diff << " (max |logit| " << scale << ")"
+                  << std::endl;
+        ok = ok && diff < 1e-3 * scale;
+
+        if (!ok) {
+            std::cout << "❌ Autotuning failed" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ GEMM autotuning working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/activation_functions.h"
+#include "../include/matrix/kernels.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/utils/file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/15_test_fast_math.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_fast_math && ./test_fast_math
+*/
+
+// Error of got in units of the last place of the correctly rounded reference
+template <typename T>
+static double ulp_error(T got, long double reference) {
+    const T rounded = static_cast<T>(reference);
+    if (std::isnan(rounded) || std::isinf(rounded)) {
+        return got == rounded || (std::isnan(got) && std::isnan(rounded)) ? 0.0 : 1e30;
+    }
+    const T magnitude = std::abs(rounded);
+    const long double ulp = (long double)std::nextafter(magnitude, std::numeric_limits<T>::infinity()) - magnitude;
+    return double(std::abs((long double)got - reference) / ulp);
+}
+
+// Max ulp error of a fast kernel over n evenly spaced points of [lo, hi]
+template <typename T, typename Reference>
+static double max_ulp(void (*kernel)(const T*, T*, size_t), Reference reference, double lo, double hi) {
+    const size_t n = 1000001;
+    std::vector<T> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<T>(lo + (hi - lo) * double(i) / double(n - 1));
+    }
+    kernel(x.data(), y.data(), n);
+    double worst = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        worst = std::max(worst, ulp_error(y[i], reference((long double)x[i])));
+    }
+    return worst;
+}
+
+template <typename T>
+static bool test_accuracy(const Kernels::KernelTable<T>& table) {
+    const char* precision = sizeof(T) == sizeof(float) ? "f32" : "f64";
+    const bool single = sizeof(T) == sizeof(float);
+    auto exp_ref = [](long double x) { return std::exp(x); };
+    auto tanh_ref = [](long double x) { return std::tanh(x); };
+    auto sigmoid_ref = [](long double x) { return 1.0L / (1.0L + std::exp(-x)); };
+
+    // Bounds documented with Kernels::MathMode
+    const double exp_ulp = max_ulp(table.exp, exp_ref, single ? -110.0 : -750.0, single ? 90.0 : 712.0);
+    const double tanh_ulp = max_ulp(table.tanh, tanh_ref, single ? -12.0 : -25.0, single ? 12.0 : 25.0);
+    const double sigmoid_ulp = max_ulp(table.sigmoid, sigmoid_ref, single ? -110.0 : -750.0, 50.0);
+    bool ok = exp_ulp <= (single ? 1.1 : 1.2) && tanh_ulp <= 1.4 && sigmoid_ulp <= (single ? 2.8 : 3.0);
+
+    // Infinities and NaN behave like libm
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    const T x[] = {-inf, inf, nan, T(0), T(-0.0)};
+    T e[5], t[5], s[5];
+    table.exp(x, e, 5);
+    table.tanh(x, t, 5);
+    table.sigmoid(x, s, 5);
+    ok = ok && e[0] == T(0) && e[1] == inf && std::isnan(e[2]) && e[3] == T(1) && e[4] == T(1);
+    ok = ok && t[0] == T(-1) && t[1] == T(1) && std::isnan(t[2]) && t[3] == T(0) && t[4] == T(0);
+    ok = ok && s[0] == T(0) && s[1] == T(1) && std::isnan(s[2]) && s[3] == T(0.5);
+
+    std::cout << (ok ? "✅ " : "❌ ") << table.name << " " << precision << " max error: exp " << exp_ulp
+              << " ulp, tanh " << tanh_ulp << " ulp, sigmoid " << sigmoid_ulp << " ulp" << std::endl;
+    return ok;
+}
+
+// Softmax, GELU, sigmoid and tanh in fast mode against exact mode, with timings
+template <typename T>
+static bool test_activations() {
+    using M = BasicMatrix<T>;
+    const char* precision = sizeof(T) == sizeof(float) ? "f32" : "f64";
+    const double tol = sizeof(T) == sizeof(float) ? 1e-6 : 1e-14;
+    M scores = M::random(400, 50, T(-8), T(8));
+    M hidden = M::random(50, 1024, T(-4), T(4));
+    M out_fast(scores.getRows(), scores.getCols()), out_exact(scores.getRows(), scores.getCols());
+    M gelu_fast(hidden.getRows(), hidden.getCols()), gelu_exact(hidden.getRows(), hidden.getCols());
+
+    auto max_diff = [](const M& a, const M& b) {
+        double diff = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            diff = std::max(diff, std::abs(double(a.data()[i]) - double(b.data()[i])) / (1.0 + std::abs(double(b.data()[i]))));
+        }
+        return diff;
+    };
+    auto time_us = [](auto&& f) {
+        const int reps = 200;
+        f();
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            f();
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / reps;
+    };
+
+    double us[2][2];
+    for (Kernels::MathMode mode : {Kernels::MathMode::Exact, Kernels::MathMode::Fast}) {
+        Kernels::set_math_mode(mode);
+        M& softmax_out = mode == Kernels::MathMode::Fast ? out_fast : out_exact;
+        M& gelu_out = mode == Kernels::MathMode::Fast ? gelu_fast : gelu_exact;
+        us[int(mode)][0] = time_us([&] { ActivationFunctions::softmax_into<T>(scores, softmax_out); });
+        us[int(mode)][1] = time_us([&] { ActivationFunctions::gelu_into<T>(hidden, gelu_out); });
+    }
+    bool ok = max_diff(out_fast, out_exact) < tol && max_diff(gelu_fast, gelu_exact) < tol;
+
+    // Column softmax is the row softmax of the transpose
+    const M columns = ActivationFunctions::softmax(scores, 0);
+    const M columns_ref = MatrixOps::transpose(ActivationFunctions::softmax(MatrixOps::transpose(scores)));
+    ok = ok && max_diff(columns, columns_ref) < tol;
+
+    // The other element-wise activations go through the same kernels
+    const M sigmoid_fast = ActivationFunctions::sigmoid(hidden);
+    const M tanh_fast = ActivationFunctions::tanh(hidden);
+    const M derivative_fast = ActivationFunctions::geluDerivative(hidden);
+    Kernels::set_math_mode(Kernels::MathMode::Exact);
+    ok = ok && max_diff(sigmoid_fast, ActivationFunctions::sigmoid(hidden)) < tol &&
+         max_diff(tanh_fast, ActivationFunctions::tanh(hidden)) < tol &&
+         max_diff(derivative_fast, ActivationFunctions::geluDerivative(hidden)) < 10 * tol;
+    Kernels::set_math_mode(Kernels::MathMode::Fast);
+
+    std::cout << (ok ? "✅ " : "❌ ") << precision << " softmax 400x50: exact " << us[0][0] << " us, fast "
+              << us[1][0] << " us; gelu 50x1024: exact " << us[0][1] << " us, fast " << us[1][1] << " us"
+              << std::endl;
+    return ok;
+}
+
+static size_t argmax_row(const MatrixF& m, size_t row) {
+    const float* p = m.row_ptr(row);
+    return std::max_element(p, p + m.getCols()) - p;
+}
+
+int main() {
+    try {
+        std::cout << "Testing fast transcendental kernels..." << std::endl;
+        bool ok = true;
+        for (Kernels::Isa isa : {Kernels::Isa::Scalar, Kernels::Isa::AVX2, Kernels::Isa::AVX512}) {
+            if (!Kernels::set_isa(isa)) {
+                std::cout << "⏭️  " << Kernels::isa_name(isa) << " not supported on this CPU" << std::endl;
+                continue;
+            }
+            ok = test_accuracy(Kernels::active_set().f32) && ok;
+            ok = test_accuracy(Kernels::active_set().f64) && ok;
+        }
+        Kernels::set_isa(Kernels::detect_isa());
+        ok = test_activations<float>() && ok;
+        ok = test_activations<double>() && ok;
+
+        // Whole model in both modes
+        VisionTransformer reference(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit(reference);
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        const size_t n = std::min<size_t>(500, images.getRows());
+        MatrixF batch = Matrix(images.block(0, 0, n, images.getCols())).cast<float>();
+
+        MatrixF logits[2];
+        double ms[2];
+        for (Kernels::MathMode mode : {Kernels::MathMode::Exact, Kernels::MathMode::Fast}) {
+            Kernels::set_math_mode(mode);
+            logits[int(mode)] = vit.forward(batch);
+            auto start = std::chrono::steady_clock::now();
+            logits[int(mode)] = vit.forward(batch);
+            ms[int(mode)] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        size_t agree = 0;
+        for (size_t i = 0; i < n; ++i) {
+            agree += argmax_row(logits[0], i) == argmax_row(logits[1], i);
+        }
+        std::cout << n << " t10k images (f32): exact " << ms[0] << " ms, fast " << ms[1] << " ms ("
+                  << ms[0] / ms[1] << "x), top-1 agreement " << agree << "/" << n << std::endl;
+        ok = ok && agree == n;
+
+        if (!ok) {
+            std::cout << "❌ Fast math diverges" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Fast transcendental kernels working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "../include/matrix/attention.h"
+#include "../include/matrix/activation_functions.h"
+#include "../include/matrix/matrix_ops.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/16_test_flash_attention.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp -pthread -o test_flash_attention && ./test_flash_attention
+*/
+
+// Attention with every head's seq_q x seq_k scores materialized, as the
+// model computed it before the fused kernel
+template <typename T>
+static void attention_unfused(size_t heads, const BasicMatrix<T>& q, const BasicMatrix<T>& k,
+                              const BasicMatrix<T>& v, BasicMatrix<T>& scores, BasicMatrix<T>& out) {
+    const size_t seq_q = q.getRows(), seq_k = k.getRows(), d = q.getCols() / heads;
+    MatrixOps::matmul_batched_into(heads, q.view().block(0, 0, seq_q, d), d, k.view().block(0, 0, seq_k, d), d,
+                                   scores.view().block(0, 0, seq_q, seq_k), seq_q * seq_k, false, true);
+    ActivationFunctions::softmax_inplace<T>(scores, static_cast<T>(1.0 / std::sqrt(double(d))));
+    MatrixOps::matmul_batched_into(heads, scores.view().block(0, 0, seq_q, seq_k), seq_q * seq_k,
+                                   v.view().block(0, 0, seq_k, d), d, out.view().block(0, 0, seq_q, d), d);
+}
+
+template <typename T>
+static double max_rel_diff(const BasicMatrix<T>& a, const BasicMatrix<T>& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff = std::max(diff, std::abs(double(a.data()[i]) - double(b.data()[i])) / (1.0 + std::abs(double(b.data()[i]))));
+    }
+    return diff;
+}
+
+// Fused against unfused on self-attention of seq_len tokens (and a single
+// query row attending to all of them), with timings
+template <typename T>
+static bool test_sequence(size_t seq_len) {
+    using M = BasicMatrix<T>;
+    const char* precision = sizeof(T) == sizeof(float) ? "f32" : "f64";
+    const double tol = sizeof(T) == sizeof(float) ? 1e-5 : 1e-12;
+    const size_t heads = 8, embed_dim = 256, d = embed_dim / heads;
+    const T scale = static_cast<T>(1.0 / std::sqrt(double(d)));
+
+    // Spread-out scores, so rows are far from uniform and maxima move between key blocks
+    M q = M::random(seq_len, embed_dim, T(-3), T(3));
+    M k = M::random(seq_len, embed_dim, T(-3), T(3));
+    M v = M::random(seq_len, embed_dim, T(-1), T(1));
+    M scores(heads * seq_len, seq_len), expected(seq_len, embed_dim), out(seq_len, embed_dim);
+
+    attention_unfused(heads, q, k, v, scores, expected);
+    Attention::attention(heads, q, k, v, out, scale);
+    double diff = max_rel_diff(out, expected);
+
+    // One query row (e.g. the class token) against every key
+    M q_row(q.view().block(0, 0, 1, embed_dim));
+    M row_out(1, embed_dim);
+    Attention::attention(heads, q_row, k, v, row_out, scale);
+    diff = std::max(diff, max_rel_diff(row_out, M(expected.view().block(0, 0, 1, embed_dim))));
+
+    const int reps = std::max(2, int(2000000 / (seq_len * seq_len)));
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        attention_unfused(heads, q, k, v, scores, expected);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        Attention::attention(heads, q, k, v, out, scale);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const bool ok = diff < tol;
+    std::cout << (ok ? "✅ " : "❌ ") << precision << " " << heads << " heads, " << seq_len << " tokens: max rel diff "
+              << diff << ", unfused " << std::chrono::duration<double, std::micro>(mid - start).count() / reps
+              << " us (" << scores.size() * sizeof(T) / 1024 << " KiB of scores), fused "
+              << std::chrono::duration<double, std::micro>(end - mid).count() / reps << " us" << std::endl;
+    return ok;
+}
+
+// Several query tiles and key blocks, with scores rising along the keys so
+// that every key block raises the running row max and the output rows are
+// rescaled (the online-softmax path a single tile never takes)
+template <typename T>
+static bool test_multi_tile() {
+    using M = BasicMatrix<T>;
+    const char* precision = sizeof(T) == sizeof(float) ? "f32" : "f64";
+    const double tol = sizeof(T) == sizeof(float) ? 1e-5 : 1e-12;
+    const size_t heads = 8, embed_dim = 256, d = embed_dim / heads;
+    const size_t block = Attention::block_size(sizeof(T), d, d);
+    const size_t seq_len = 2 * block + 7;
+
+    M q = M::random(seq_len, embed_dim, T(0.5), T(1));
+    M k = M::random(seq_len, embed_dim, T(0), T(0.2));
+    for (size_t j = 0; j < seq_len; ++j) {
+        for (size_t c = 0; c < embed_dim; ++c) {
+            k(j, c) += static_cast<T>(2.0 * double(j) / double(seq_len));
+        }
+    }
+    M v = M::random(seq_len, embed_dim, T(-1), T(1));
+    M scores(heads * seq_len, seq_len), expected(seq_len, embed_dim), out(seq_len, embed_dim);
+
+    attention_unfused(heads, q, k, v, scores, expected);
+    Attention::attention(heads, q, k, v, out, static_cast<T>(1.0 / std::sqrt(double(d))));
+    const double diff = max_rel_diff(out, expected);
+
+    const bool ok = diff < tol && seq_len > block;
+    std::cout << (ok ? "✅ " : "❌ ") << precision << " " << seq_len << " tokens in " << block
+              << "-row tiles, rising scores: max rel diff " << diff << std::endl;
+    return ok;
+}
+
+int main() {
+    try {
+        std::cout << "Testing fused attention..." << std::endl;
+        bool ok = true;
+
+        // 50 tokens is the MNIST model with 4 px patches, 197 and 785 the same
+        // images in 2 px and 1 px patches; 300 just crosses a tile edge
+        for (size_t seq_len : {1, 50, 197, 300, 785}) {
+            ok = test_sequence<float>(seq_len) && ok;
+            ok = test_sequence<double>(seq_len) && ok;
+        }
+
+        ok = test_multi_tile<float>() && ok;
+        ok = test_multi_tile<double>() && ok;
+
+        // Mismatched shapes are rejected
+        bool threw = false;
+        try {
+            MatrixF q(4, 64), k(5, 64), v(6, 64), out(4, 64);
+            Attention::attention(8, q, k, v, out, 1.0f);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        std::cout << (threw ? "✅ " : "❌ ") << "Mismatched K and V rows throw" << std::endl;
+        ok = ok && threw;
+
+        if (!ok) {
+            std::cout << "❌ Fused attention diverges" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Fused attention working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
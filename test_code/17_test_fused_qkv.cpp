@@ -0,0 +1,136 @@
+#include "../include/transformer/multi_head_attention.h"
+#include "../include/matrix/matrix_ops.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/17_test_fused_qkv.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp -pthread -o test_fused_qkv && ./test_fused_qkv
+*/
+
+template <typename T>
+static double max_rel_diff(const BasicMatrix<T>& a, const BasicMatrix<T>& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff = std::max(diff, std::abs(double(a.data()[i]) - double(b.data()[i])) / (1.0 + std::abs(double(b.data()[i]))));
+    }
+    return diff;
+}
+
+// Forward through the fused projection against three separate projections
+// of the same weights, loaded with set_weights
+template <typename T>
+static bool test_projection(size_t seq_len) {
+    using M = BasicMatrix<T>;
+    const char* precision = sizeof(T) == sizeof(float) ? "f32" : "f64";
+    const double tol = sizeof(T) == sizeof(float) ? 1e-5 : 1e-12;
+    const size_t embed_dim = 256, heads = 8;
+    const T w = static_cast<T>(std::sqrt(2.0 / embed_dim));
+
+    M W_q = M::random(embed_dim, embed_dim, -w, w);
+    M W_k = M::random(embed_dim, embed_dim, -w, w);
+    M W_v = M::random(embed_dim, embed_dim, -w, w);
+    M W_o = M::random(embed_dim, embed_dim, -w, w);
+    M input = M::random(seq_len, embed_dim);
+
+    BasicMultiHeadAttention<T> mha(embed_dim, heads);
+    mha.set_weights(W_q, W_k, W_v, W_o);
+    const M out = mha.forward(input);
+
+    // Reference: separate Q, K and V, one head at a time
+    const size_t d = embed_dim / heads;
+    const M Q = MatrixOps::matmul(input, W_q), K = MatrixOps::matmul(input, W_k), V = MatrixOps::matmul(input, W_v);
+    M heads_out(seq_len, embed_dim);
+    for (size_t h = 0; h < heads; ++h) {
+        mha.scaled_dot_product_attention(Q.view().block(0, h * d, seq_len, d), K.view().block(0, h * d, seq_len, d),
+                                         V.view().block(0, h * d, seq_len, d),
+                                         heads_out.view().block(0, h * d, seq_len, d));
+    }
+    const M expected = MatrixOps::matmul(heads_out, W_o);
+    const double diff = max_rel_diff(out, expected);
+
+    const int reps = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        mha.forward(input);
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / reps;
+
+    // The class token alone: Q for row 0, K and V for every token
+    M cls(1, embed_dim);
+    Workspace workspace;
+    mha.forward(input, cls, workspace);
+    const double cls_diff = max_rel_diff(cls, M(expected.view().block(0, 0, 1, embed_dim)));
+
+    const bool ok = diff < tol && cls_diff < tol;
+    std::cout << (ok ? "✅ " : "❌ ") << precision << " " << seq_len << " tokens: max rel diff " << diff
+              << ", class token " << cls_diff << ", forward " << us << " us" << std::endl;
+    return ok;
+}
+
+// The split projection of the class token against row 0 of the full forward,
+// with the weights in 16-bit storage and in int8
+static bool test_cls_storage() {
+    const size_t seq_len = 50, embed_dim = 256;
+    const MatrixF input = MatrixF::random(seq_len, embed_dim);
+    bool ok = true;
+    for (int variant = 0; variant < 2; ++variant) {
+        MultiHeadAttentionF mha(embed_dim, 8);
+        if (variant == 0) {
+            mha.set_weight_storage(WeightStorage::BF16);
+        } else {
+            mha.set_calibrating(true);
+            mha.forward(input);
+            mha.set_calibrating(false);
+            mha.quantize();
+        }
+        const MatrixF full = mha.forward(input);
+        MatrixF cls(1, embed_dim);
+        Workspace workspace;
+        mha.forward(input, cls, workspace);
+        const double diff = max_rel_diff(cls, MatrixF(full.view().block(0, 0, 1, embed_dim)));
+        const bool same = diff < 1e-5;
+        std::cout << (same ? "✅ " : "❌ ") << (variant == 0 ? "bf16" : "int8")
+                  << " class token against the full forward: max rel diff " << diff << std::endl;
+        ok = ok && same;
+    }
+    return ok;
+}
+
+int main() {
+    try {
+        std::cout << "Testing fused QKV projection..." << std::endl;
+        bool ok = true;
+        for (size_t seq_len : {1, 50, 197}) {
+            ok = test_projection<float>(seq_len) && ok;
+            ok = test_projection<double>(seq_len) && ok;
+        }
+
+        ok = test_cls_storage() && ok;
+
+        // Projections of the wrong size are rejected
+        bool threw = false;
+        try {
+            MultiHeadAttentionF mha(256, 8);
+            MatrixF square(256, 256), wide(256, 768);
+            mha.set_weights(wide, square, square, square);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        std::cout << (threw ? "✅ " : "❌ ") << "Mis-sized projection throws" << std::endl;
+        ok = ok && threw;
+
+        if (!ok) {
+            std::cout << "❌ Fused QKV projection diverges" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Fused QKV projection working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
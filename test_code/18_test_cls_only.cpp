@@ -0,0 +1,98 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/matrix_ops.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/18_test_cls_only.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_cls_only && ./test_cls_only
+*/
+
+template <typename T>
+static double max_rel_diff(BasicConstMatrixView<T> a, BasicConstMatrixView<T> b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.getRows(); ++i) {
+        for (size_t j = 0; j < a.getCols(); ++j) {
+            diff = std::max(diff, std::abs(double(a(i, j)) - double(b(i, j))) / (1.0 + std::abs(double(b(i, j)))));
+        }
+    }
+    return diff;
+}
+
+// A block run for the class token alone against row 0 of the full block
+template <typename T>
+static bool test_block(size_t seq_len) {
+    using M = BasicMatrix<T>;
+    const char* precision = sizeof(T) == sizeof(float) ? "f32" : "f64";
+    // The class-token run sums in another order (other GEMM shapes), and f32
+    // rounding over the 1024-deep MLP reaches ~1e-5
+    const double tol = sizeof(T) == sizeof(float) ? 1e-4 : 1e-12;
+    const size_t embed_dim = 256;
+
+    BasicTransformerBlock<T> block(embed_dim, 8, 1024);
+    M input = M::random(seq_len, embed_dim);
+    Workspace workspace;
+
+    M full(seq_len, embed_dim), normed(seq_len, embed_dim);
+    block.input_norm().forward(input, normed);
+    block.forward(input, normed, full, nullptr, workspace);
+
+    M cls(1, embed_dim);
+    block.input_norm().forward(input, normed);
+    block.forward(input, normed, cls, nullptr, workspace);
+    const double diff = max_rel_diff<T>(cls, full.view().block(0, 0, 1, embed_dim));
+
+    // In place, as the model runs it: only row 0 of input changes
+    M in_place = input;
+    block.input_norm().forward(in_place, normed);
+    block.forward(in_place, normed, in_place.view().row(0), nullptr, workspace);
+    const bool rest_kept = max_rel_diff<T>(in_place.view().block(1, 0, seq_len - 1, embed_dim),
+                                           input.view().block(1, 0, seq_len - 1, embed_dim)) == 0.0;
+    const bool in_place_ok = max_rel_diff<T>(in_place.view().row(0), cls.view()) == 0.0;
+
+    const bool ok = diff < tol && rest_kept && in_place_ok;
+    std::cout << (ok ? "✅ " : "❌ ") << precision << " " << seq_len << " tokens: class token max rel diff " << diff
+              << (rest_kept && in_place_ok ? "" : ", in-place run differs") << std::endl;
+    return ok;
+}
+
+int main() {
+    try {
+        std::cout << "Testing class-token-only last block..." << std::endl;
+        bool ok = true;
+        for (size_t seq_len : {2, 50, 197}) {
+            ok = test_block<float>(seq_len) && ok;
+            ok = test_block<double>(seq_len) && ok;
+        }
+
+        // Whole model: the last block now runs the norms and MLP on one row
+        VisionTransformer reference(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit(reference);
+        MatrixF batch = MatrixF::random(200, 784, 0.0f, 1.0f);
+        MatrixF logits = vit.forward(batch);
+        auto start = std::chrono::steady_clock::now();
+        logits = vit.forward(batch);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "200 images (f32): " << ms << " ms" << std::endl;
+
+        // The float model still tracks the double reference
+        Matrix logits_ref = reference.forward(batch.cast<double>());
+        const double logit_diff = max_rel_diff<float>(logits, logits_ref.cast<float>());
+        std::cout << (logit_diff < 1e-3 ? "✅ " : "❌ ") << "f32 logits against f64: max rel diff " << logit_diff
+                  << std::endl;
+        ok = ok && logit_diff < 1e-3;
+
+        if (!ok) {
+            std::cout << "❌ Class-token-only block diverges" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Class-token-only last block working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/utils/file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/19_test_early_exit.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_early_exit && ./test_early_exit
+*/
+
+static size_t argmax_row(const MatrixF& m, size_t row) {
+    const float* p = m.row_ptr(row);
+    return std::max_element(p, p + m.getCols()) - p;
+}
+
+static double max_abs_diff(const MatrixF& a, const MatrixF& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff = std::max(diff, double(std::abs(a.data()[i] - b.data()[i])));
+    }
+    return diff;
+}
+
+int main() {
+    try {
+        std::cout << "Testing early-exit classification..." << std::endl;
+        bool ok = true;
+
+        VisionTransformer reference(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit(reference);
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        const size_t n = std::min<size_t>(500, images.getRows());
+        MatrixF batch = Matrix(images.block(0, 0, n, images.getCols())).cast<float>();
+
+        auto time_ms = [&](MatrixF& logits) {
+            auto start = std::chrono::steady_clock::now();
+            logits = vit.forward(batch);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+        MatrixF full;
+        vit.forward(batch);
+        const double full_ms = time_ms(full);
+
+        // Heads after blocks 2 and 4
+        const float scale = std::sqrt(2.0f / 256);
+        vit.set_exit_head(2, MatrixF::random(256, 10) * scale);
+        vit.set_exit_head(4, MatrixF::random(256, 10) * scale);
+
+        // Threshold 1 never exits: same logits, every image runs all blocks
+        MatrixF logits;
+        vit.reset_exit_stats();
+        const bool never = max_abs_diff(vit.forward(batch), full) == 0.0 && vit.getExitCounts().back() == n;
+        std::cout << (never ? "✅ " : "❌ ") << "Threshold 1 runs every block" << std::endl;
+        ok = ok && never;
+
+        // Accuracy (as agreement with the full model) against mean depth. The
+        // model and heads are untrained, so this shows the mechanism only.
+        for (double threshold : {0.999, 0.99, 0.9, 0.5, 0.0}) {
+            vit.set_exit_threshold(threshold);
+            vit.reset_exit_stats();
+            const double ms = time_ms(logits);
+            size_t agree = 0;
+            for (size_t i = 0; i < n; ++i) {
+                agree += argmax_row(logits, i) == argmax_row(full, i);
+            }
+            const std::vector<size_t>& exits = vit.getExitCounts();
+            std::cout << "  threshold " << threshold << ": exits after block 2/4/6 " << exits[1] << "/" << exits[3]
+                      << "/" << exits[5] << ", mean " << vit.getMeanLayers() << " blocks, " << ms << " ms (full "
+                      << full_ms << " ms), agreement " << agree << "/" << n << std::endl;
+        }
+
+        // Threshold 0 stops every image at the first head
+        const bool all_first = vit.getExitCounts()[1] == n && vit.getMeanLayers() == 2.0;
+        std::cout << (all_first ? "✅ " : "❌ ") << "Threshold 0 exits at the first head" << std::endl;
+        ok = ok && all_first;
+
+        // The heads follow the model into the other precision and into 16-bit storage
+        VisionTransformer copy(vit);
+        copy.set_weight_storage(WeightStorage::BF16);
+        copy.reset_exit_stats();
+        copy.forward(batch.cast<double>());
+        const bool copied = copy.getExitCounts()[1] == n;
+        std::cout << (copied ? "✅ " : "❌ ") << "Exit heads survive precision and storage changes" << std::endl;
+        ok = ok && copied;
+
+        // Heads only go between blocks
+        bool threw = false;
+        try {
+            vit.set_exit_head(6, MatrixF(256, 10));
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        std::cout << (threw ? "✅ " : "❌ ") << "Exit head after the last block throws" << std::endl;
+        ok = ok && threw;
+
+        if (!ok) {
+            std::cout << "❌ Early exit failed" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Early-exit classification working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/utils/file_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+/*
+g++ -std=c++17 -O2 -I. test_code/20_test_token_reduction.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/workspace.cpp src/matrix/gemm.cpp src/matrix/gemm_tuning.cpp src/matrix/packed_weight.cpp src/matrix/quantized_weight.cpp src/matrix/attention.cpp src/matrix/kernels/dispatch.cpp src/matrix/kernels/kernels_scalar.cpp src/matrix/kernels/kernels_avx2.cpp src/matrix/kernels/kernels_avx512.cpp src/utils/thread_pool.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/embedding.cpp src/transformer/vision_transformer.cpp src/utils/file_io.cpp -pthread -o test_token_reduction && ./test_token_reduction
+*/
+
+static size_t argmax_row(const MatrixF& m, size_t row) {
+    const float* p = m.row_ptr(row);
+    return std::max_element(p, p + m.getCols()) - p;
+}
+
+int main() {
+    try {
+        std::cout << "Testing token pruning and merging..." << std::endl;
+        bool ok = true;
+
+        // The class token's attention is a probability distribution over tokens
+        MultiHeadAttentionF mha(256, 8);
+        MatrixF tokens = MatrixF::random(50, 256), out(50, 256), cls_attention(1, 50);
+        Workspace workspace;
+        mha.forward(tokens, out, workspace, cls_attention);
+        double total = 0.0;
+        for (size_t j = 0; j < 50; ++j) {
+            total += cls_attention(0, j);
+        }
+        const bool distribution = std::abs(total - 1.0) < 1e-5;
+        std::cout << (distribution ? "✅ " : "❌ ") << "Head-averaged class-token attention sums to " << total
+                  << std::endl;
+        ok = ok && distribution;
+
+        VisionTransformer reference(28, 4, 256, 8, 6, 10);
+        VisionTransformerF vit(reference);
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        std::vector<int> labels = FileIO::load_mnist_labels("data/t10k-labels-idx1-ubyte/t10k-labels-idx1-ubyte");
+        const size_t n = std::min<size_t>(500, images.getRows());
+        MatrixF batch = Matrix(images.block(0, 0, n, images.getCols())).cast<float>();
+
+        auto run = [&](MatrixF& logits) {
+            vit.reset_exit_stats();
+            auto start = std::chrono::steady_clock::now();
+            logits = vit.forward(batch);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+        MatrixF full;
+        vit.forward(batch);
+        const double full_ms = run(full);
+
+        // Keep ratio 1 changes nothing
+        MatrixF logits;
+        vit.set_token_reduction(TokenReduction::Prune, {1.0, 1.0, 1.0, 1.0, 1.0});
+        run(logits);
+        bool unchanged = vit.getMeanTokens() == 50.0;
+        for (size_t i = 0; i < logits.size(); ++i) {
+            unchanged = unchanged && logits.data()[i] == full.data()[i];
+        }
+        std::cout << (unchanged ? "✅ " : "❌ ") << "Keep ratio 1 leaves the logits unchanged" << std::endl;
+        ok = ok && unchanged;
+
+        // Accuracy and agreement with the full model against throughput. The
+        // weights are untrained, so accuracy is near chance either way.
+        struct Setting {
+            TokenReduction mode;
+            const char* name;
+            std::vector<double> keep;
+            double mean_tokens;  // Expected mean sequence length over the 6 blocks
+        };
+        const Setting settings[] = {
+            {TokenReduction::Prune, "prune 0.7/layer", {0.7, 0.7, 0.7, 0.7, 0.7}, (50 + 35 + 25 + 18 + 13 + 9) / 6.0},
+            {TokenReduction::Prune, "prune 0.5 after block 1", {0.5}, (50 + 5 * 26) / 6.0},
+            {TokenReduction::Merge, "merge 0.7/layer", {0.7, 0.7, 0.7, 0.7, 0.7}, (50 + 35 + 25 + 18 + 13 + 9) / 6.0},
+            {TokenReduction::Merge, "merge 0.5 after block 1", {0.5}, (50 + 5 * 26) / 6.0},
+        };
+        for (const Setting& setting : settings) {
+            vit.set_token_reduction(setting.mode, setting.keep);
+            const double ms = run(logits);
+            size_t agree = 0, correct = 0, correct_full = 0;
+            for (size_t i = 0; i < n; ++i) {
+                agree += argmax_row(logits, i) == argmax_row(full, i);
+                correct += int(argmax_row(logits, i)) == labels[i];
+                correct_full += int(argmax_row(full, i)) == labels[i];
+            }
+            const bool lengths = std::abs(vit.getMeanTokens() - setting.mean_tokens) < 1e-9;
+            std::cout << (lengths ? "✅ " : "❌ ") << setting.name << ": mean " << vit.getMeanTokens()
+                      << " tokens, " << ms << " ms (full " << full_ms << " ms, " << full_ms / ms
+                      << "x), accuracy " << correct << "/" << n << " (full " << correct_full << "), agreement "
+                      << agree << "/" << n << std::endl;
+            ok = ok && lengths;
+        }
+
+        // Two halves of the batch at once, each with its own workspace, give
+        // the same logits as one pass over the whole batch
+        vit.set_token_reduction(TokenReduction::Merge, {0.7, 0.7, 0.7, 0.7, 0.7});
+        const MatrixF sequential = vit.forward(batch);
+        MatrixF concurrent(n, logits.getCols());
+        Workspace workspaces[2];
+        std::thread threads[2];
+        for (size_t t = 0; t < 2; ++t) {
+            threads[t] = std::thread([&, t] {
+                const size_t begin = t * n / 2, rows = (t + 1) * n / 2 - begin;
+                vit.forward(batch.view().block(begin, 0, rows, batch.getCols()),
+                            concurrent.view().block(begin, 0, rows, concurrent.getCols()), workspaces[t]);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        bool same = true;
+        for (size_t i = 0; i < concurrent.size(); ++i) {
+            same = same && concurrent.data()[i] == sequential.data()[i];
+        }
+        std::cout << (same ? "✅ " : "❌ ") << "Concurrent forward passes with separate workspaces agree"
+                  << std::endl;
+        ok = ok && same;
+
+        bool threw = false;
+        try {
+            vit.set_token_reduction(TokenReduction::Prune, {0.0});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        std::cout << (threw ? "✅ " : "❌ ") << "Keep ratio 0 throws" << std::endl;
+        ok = ok && threw;
+
+        if (!ok) {
+            std::cout << "❌ Token reduction failed" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Token pruning and merging working!" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}